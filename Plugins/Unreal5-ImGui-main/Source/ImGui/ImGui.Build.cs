@@ -98,5 +98,14 @@ public class ImGui : ModuleRules
 #endif
 
 		PrivateDefinitions.Add(string.Format("RUNTIME_LOADER_ENABLED={0}", bEnableRuntimeLoader ? 1 : 0));
+
+		// Slate indices are 32-bit since UE5. Using the same width for ImGui indices lets index data be copied as is and
+		// lifts the 64K vertex limit of a single draw list. Public, because every module including imgui.h must agree.
+#if UE_5_0_OR_LATER
+		bool bUse32BitIndices = true;
+#else
+		bool bUse32BitIndices = false;
+#endif
+		PublicDefinitions.Add(string.Format("IMGUI_USE_32BIT_INDICES={0}", bUse32BitIndices ? 1 : 0));
 	}
 }
@@ -9,6 +9,8 @@
 #include "Utilities/WorldContext.h"
 #include "Utilities/WorldContextIndex.h"
 
+#include <Framework/Application/SlateApplication.h>
+
 #include <imgui.h>
 
 
@@ -74,6 +76,12 @@ FImGuiContextManager::FImGuiContextManager(FImGuiModuleSettings& InSettings)
 
 FImGuiContextManager::~FImGuiContextManager()
 {
+	// Worker thread might still be building a font atlas that we own.
+	if (FontAtlasBuildTask.IsValid())
+	{
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(FontAtlasBuildTask);
+	}
+
 	// Early dealloc of contexts for clean shutdown order
 	Contexts.Reset();
 	
@@ -111,6 +119,22 @@ void FImGuiContextManager::Tick(float DeltaSeconds)
 	{
 		FontResourcesToRelease.Empty();
 	}
+
+	// Swapping after the countdown gives old resources the full countdown from the next tick.
+	UpdateFontAtlasBuild();
+}
+
+FImGuiContextProxy* FImGuiContextManager::GetCurrentContextProxy()
+{
+	for (auto& Pair : Contexts)
+	{
+		if (Pair.Value.ContextProxy->IsCurrentContext())
+		{
+			return Pair.Value.ContextProxy.Get();
+		}
+	}
+
+	return nullptr;
 }
 
 #if ENGINE_COMPATIBILITY_LEGACY_WORLD_ACTOR_TICK
@@ -143,7 +167,15 @@ void FImGuiContextManager::OnWorldPostActorTick(UWorld* World, ELevelTick TickTy
 	if (World && (World->WorldType == EWorldType::Game || World->WorldType == EWorldType::PIE
 		|| World->WorldType == EWorldType::Editor))
 	{
-		GetWorldContextProxy(*World).DrawDebug();
+		FImGuiContextProxy& ContextProxy = GetWorldContextProxy(*World);
+		ContextProxy.DrawDebug();
+
+		// With decoupled paint, this is where the frame ends. Its draw data are converted on a worker thread while
+		// the game thread does the rest of the frame and paint only submits them.
+		if (FImGuiContextProxy::IsPaintDecoupled() && FSlateApplication::IsInitialized())
+		{
+			ContextProxy.Tick(FSlateApplication::Get().GetDeltaTime());
+		}
 	}
 }
 #endif // ENGINE_COMPATIBILITY_WITH_WORLD_POST_ACTOR_TICK
@@ -259,31 +291,35 @@ void FImGuiContextManager::SetDPIScale(const FImGuiDPIScaleInfo& ScaleInfo)
 	}
 }
 
-void FImGuiContextManager::BuildFontAtlas(const TMap<FName, TSharedPtr<ImFontConfig>>& CustomFontConfigs)
+void FImGuiContextManager::AddFonts(ImFontAtlas& Atlas, const TMap<FName, TSharedPtr<ImFontConfig>>& CustomFontConfigs)
 {
-	if (!FontAtlas.IsBuilt())
-	{
-		ImFontConfig FontConfig = {};
-		FontConfig.SizePixels = FMath::RoundFromZero(13.f * DPIScale);
-		FontAtlas.AddFontDefault(&FontConfig);
+	ImFontConfig FontConfig = {};
+	FontConfig.SizePixels = FMath::RoundFromZero(13.f * DPIScale);
+	Atlas.AddFontDefault(&FontConfig);
 
-		// Build custom fonts
-		for (const TPair<FName, TSharedPtr<ImFontConfig>>& CustomFontPair : CustomFontConfigs)
-		{
-			FName CustomFontName = CustomFontPair.Key;
-			TSharedPtr<ImFontConfig> CustomFontConfig = CustomFontPair.Value;
+	// Build custom fonts
+	for (const TPair<FName, TSharedPtr<ImFontConfig>>& CustomFontPair : CustomFontConfigs)
+	{
+		FName CustomFontName = CustomFontPair.Key;
+		TSharedPtr<ImFontConfig> CustomFontConfig = CustomFontPair.Value;
 
 
-			// Set font name for debugging
-			if (CustomFontConfig.IsValid())
-			{
-				FCStringAnsi::Strncpy(CustomFontConfig->Name, TCHAR_TO_ANSI(*CustomFontName.ToString()), 40);
-				CustomFontConfig->Name[39] = '\0';
-			}
-			
-			ImFont* font{FontAtlas.AddFont(CustomFontConfig.Get())};
-			font->ContainerAtlas = &FontAtlas;
+		// Set font name for debugging
+		if (CustomFontConfig.IsValid())
+		{
+			FCStringAnsi::Strncpy(CustomFontConfig->Name, TCHAR_TO_ANSI(*CustomFontName.ToString()), 40);
+			CustomFontConfig->Name[39] = '\0';
 		}
+		
+		Atlas.AddFont(CustomFontConfig.Get());
+	}
+}
+
+void FImGuiContextManager::BuildFontAtlas(const TMap<FName, TSharedPtr<ImFontConfig>>& CustomFontConfigs)
+{
+	if (!FontAtlas.IsBuilt())
+	{
+		AddFonts(FontAtlas, CustomFontConfigs);
 
 		unsigned char* Pixels;
 		int Width, Height, Bpp;
@@ -295,16 +331,74 @@ void FImGuiContextManager::BuildFontAtlas(const TMap<FName, TSharedPtr<ImFontCon
 
 void FImGuiContextManager::RebuildFontAtlas()
 {
-	if (FontAtlas.IsBuilt())
+	if (!FontAtlas.IsBuilt())
+	{
+		// Contexts cannot start a frame without fonts, so the first atlas is built right away.
+		BuildFontAtlas(FImGuiModule::Get().GetProperties().GetCustomFonts());
+	}
+	else if (FontAtlasBuildTask.IsValid())
+	{
+		// Atlas that is being built is already out of date. It will be discarded and built again when finished.
+		bFontAtlasRebuildRequested = true;
+	}
+	else
 	{
-		// Keep the old resources alive for a few frames to give all contexts a chance to bind to new ones.
-		FontResourcesToRelease.Add(TUniquePtr<ImFontAtlas>(new ImFontAtlas()));
-		Swap(*FontResourcesToRelease.Last(), FontAtlas);
+		LaunchFontAtlasBuild();
+	}
+}
+
+void FImGuiContextManager::LaunchFontAtlasBuild()
+{
+	// Fonts are added here, using the current DPI scale and custom fonts. Only rasterization runs on the worker thread.
+	PendingFontAtlas = MakeUnique<ImFontAtlas>();
+	AddFonts(*PendingFontAtlas, FImGuiModule::Get().GetProperties().GetCustomFonts());
+	bFontAtlasRebuildRequested = false;
 
-		// Typically, one frame should be enough but since we allow for custom ticking, we need at least to frames to
-		// wait for contexts that already ticked and will not do that before the end of the next tick of this manager.
-		FontResourcesReleaseCountdown = 3;
+	// There is no current ImGui context on worker threads, so allocations made while building don't touch contexts.
+	FontAtlasBuildTask = FFunctionGraphTask::CreateAndDispatchWhenReady([Atlas = PendingFontAtlas.Get()]()
+	{
+		unsigned char* Pixels;
+		int Width, Height, Bpp;
+		Atlas->GetTexDataAsRGBA32(&Pixels, &Width, &Height, &Bpp);
+	}, TStatId{}, nullptr, ENamedThreads::AnyBackgroundThreadNormalTask);
+}
+
+void FImGuiContextManager::UpdateFontAtlasBuild()
+{
+	if (!FontAtlasBuildTask.IsValid() || !FontAtlasBuildTask->IsComplete())
+	{
+		return;
+	}
+
+	FontAtlasBuildTask = nullptr;
+
+	if (bFontAtlasRebuildRequested)
+	{
+		LaunchFontAtlasBuild();
+		return;
 	}
 
-	BuildFontAtlas(FImGuiModule::Get().GetProperties().GetCustomFonts());
+	// Keep the old resources alive for a few frames to give all contexts a chance to bind to new ones. Contexts point
+	// to the FontAtlas object, so swapping its content switches all of them at once.
+	FontResourcesToRelease.Add(MakeUnique<ImFontAtlas>());
+	ImFontAtlas& OldFontAtlas = *FontResourcesToRelease.Last();
+	Swap(OldFontAtlas, FontAtlas);
+	Swap(FontAtlas, *PendingFontAtlas);
+	PendingFontAtlas.Reset();
+
+	// Fonts point back to the atlas object that built them.
+	for (ImFont* Font : OldFontAtlas.Fonts)
+	{
+		Font->ContainerAtlas = &OldFontAtlas;
+	}
+	for (ImFont* Font : FontAtlas.Fonts)
+	{
+		Font->ContainerAtlas = &FontAtlas;
+	}
+
+	// Typically, one frame should be enough but since we allow for custom ticking, we need at least to frames to
+	// wait for contexts that already ticked and will not do that before the end of the next tick of this manager.
+	FontResourcesReleaseCountdown = 3;
+
+	OnFontAtlasBuilt.Broadcast();
 }
@@ -58,6 +58,9 @@ public:
 		return Data ? Data->ContextProxy.Get() : nullptr;
 	}
 
+	// Get context proxy of the current ImGui context, or null if the current context isn't managed here.
+	FImGuiContextProxy* GetCurrentContextProxy();
+
 	// Delegate called when a new context proxy is created.
 	FContextProxyCreatedDelegate OnContextProxyCreated;
 
@@ -106,11 +109,25 @@ private:
 	void SetDPIScale(const FImGuiDPIScaleInfo& ScaleInfo);
 	void BuildFontAtlas(const TMap<FName, TSharedPtr<ImFontConfig>>& CustomFontConfigs = {});
 
+	// Add the default and custom fonts to an atlas, without building it.
+	void AddFonts(ImFontAtlas& Atlas, const TMap<FName, TSharedPtr<ImFontConfig>>& CustomFontConfigs);
+
+	// Start building a new font atlas on a worker thread.
+	void LaunchFontAtlasBuild();
+
+	// Swap in the font atlas built on a worker thread, if it is ready.
+	void UpdateFontAtlasBuild();
+
 	TMap<int32, FContextData> Contexts;
 
 	ImFontAtlas FontAtlas;
 	TArray<TUniquePtr<ImFontAtlas>> FontResourcesToRelease;
 
+	// Rebuilt atlas is rasterized on a worker thread, while contexts keep using the current one.
+	TUniquePtr<ImFontAtlas> PendingFontAtlas;
+	FGraphEventRef FontAtlasBuildTask;
+	bool bFontAtlasRebuildRequested = false;
+
 	FImGuiModuleSettings& Settings;
 
 	float DPIScale = -1.f;
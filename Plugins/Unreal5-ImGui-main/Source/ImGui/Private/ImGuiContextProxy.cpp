@@ -9,13 +9,32 @@
 #include "VersionCompatibility.h"
 
 #include <GenericPlatform/GenericPlatformFile.h>
+#include <HAL/IConsoleManager.h>
 #include <Misc/Paths.h>
 
+#include <imgui_internal.h>
+
 
 static constexpr float DEFAULT_CANVAS_WIDTH = 3840.f;
 static constexpr float DEFAULT_CANVAS_HEIGHT = 2160.f;
 
 
+namespace CVars
+{
+	TAutoConsoleVariable<int> DecoupledPaint(TEXT("ImGui.DecoupledPaint"), 0,
+		TEXT("Where ImGui frames end and their draw data are converted for Slate.\n")
+		TEXT("0: frames end during widget paint, which also converts draw data (default)\n")
+		TEXT("1: frames end after the world tick and draw data are converted on a worker thread, paint only submits them"),
+		ECVF_Default);
+
+	TAutoConsoleVariable<float> IdleUpdateRate(TEXT("ImGui.IdleUpdateRate"), 0.f,
+		TEXT("Rate in Hz at which ImGui contexts are rendered while idle (no input, active items or keep-alive requests).\n")
+		TEXT("In between, frames are still built but discarded without rendering, and widgets show the last draw data.\n")
+		TEXT("0: idle contexts are rendered every frame (default)"),
+		ECVF_Default);
+}
+
+
 namespace
 {
 	FString GetSaveDirectory()
@@ -117,6 +136,9 @@ FImGuiContextProxy::~FImGuiContextProxy()
 		// Ensure frame has ended
 		EndFrame();	
 
+		// Conversion task refers to our draw data.
+		WaitForConversion();
+
 		// Manually save data session.
 		ImGui::SaveIniSettingsToDisk(StringCast<ANSICHAR>(*IniFilename).Get());
 		
@@ -176,6 +198,26 @@ void FImGuiContextProxy::DrawDebug()
 	}
 }
 
+bool FImGuiContextProxy::IsPaintDecoupled()
+{
+	return CVars::DecoupledPaint.GetValueOnGameThread() > 0;
+}
+
+TArray<FImGuiDrawListCache>& FImGuiContextProxy::SwapConvertedDrawData(const FTransform2D& Transform)
+{
+	if (bBackFrameReady)
+	{
+		WaitForConversion();
+		FrontFrame ^= 1;
+		bBackFrameReady = false;
+	}
+
+	PaintTransform = Transform;
+	bHasPaintTransform = true;
+
+	return DrawFrames[FrontFrame].DrawListCaches;
+}
+
 void FImGuiContextProxy::Tick(float DeltaSeconds)
 {
 	// Making sure that we tick only once per frame.
@@ -185,14 +227,33 @@ void FImGuiContextProxy::Tick(float DeltaSeconds)
 
 		SetAsCurrent();
 
+		TimeSinceRender += DeltaSeconds;
+
+		// Idle frames are discarded without rendering, so widgets reuse the last draw data. Frames are still started
+		// every tick, because controls are also drawn outside of draw events, e.g. from actor ticks.
+		const float IdleUpdateRate = CVars::IdleUpdateRate.GetValueOnGameThread();
+		const bool bThrottled = bIsFrameStarted && IdleUpdateRate > 0.f && TimeSinceRender < 1.f / IdleUpdateRate && IsIdle();
+
+		// Requests are made while drawing, so they apply to the frame that ends now.
+		bKeepAliveRequested = false;
+
 		if (bIsFrameStarted)
 		{
 			// Make sure that draw events are called before the end of the frame.
 			DrawDebug();
 
-			// Ending frame will produce render output that we capture and store for later use. This also puts context to
-			// state in which it does not allow to draw controls, so we want to immediately start a new frame.
-			EndFrame();
+			if (bThrottled)
+			{
+				DiscardFrame();
+			}
+			else
+			{
+				// Ending frame will produce render output that we capture and store for later use. This also puts
+				// context to state in which it does not allow to draw controls, so we want to immediately start a new
+				// frame.
+				EndFrame();
+				TimeSinceRender = 0.f;
+			}
 		}
 
 		// Update context information (some data need to be collected before starting a new frame while some other data
@@ -208,6 +269,13 @@ void FImGuiContextProxy::Tick(float DeltaSeconds)
 	}
 }
 
+bool FImGuiContextProxy::IsIdle() const
+{
+	const ImGuiIO& IO = Context->IO;
+	return !bKeepAliveRequested && !bHasActiveItem && !IO.WantTextInput && !ImGui::IsAnyMouseDown()
+		&& !bFrameHadInput && IO.DisplaySize.x == DisplaySize.X && IO.DisplaySize.y == DisplaySize.Y;
+}
+
 void FImGuiContextProxy::BeginFrame(float DeltaTime)
 {
 	if (!bIsFrameStarted)
@@ -221,7 +289,9 @@ void FImGuiContextProxy::BeginFrame(float DeltaTime)
 
 
 		IO.DisplaySize = ImVec2(DisplaySize.X, DisplaySize.Y);
-		
+
+		// New frame consumes queued input events, so remember whether this frame is the one handling them.
+		bFrameHadInput = Context->InputEventsQueue.Size > 0;
 		ImGui::NewFrame();
 
 		bIsFrameStarted = true;
@@ -245,8 +315,24 @@ void FImGuiContextProxy::EndFrame()
 	}
 }
 
+void FImGuiContextProxy::DiscardFrame()
+{
+	if (bIsFrameStarted)
+	{
+		// Finish the frame without preparing draw data, the last ones stay in use.
+		ImGui::EndFrame();
+
+		bIsFrameStarted = false;
+	}
+}
+
 void FImGuiContextProxy::UpdateDrawData(ImDrawData* DrawData)
 {
+	// Back buffer might still be converted from the previous frame, if it was not painted since then.
+	WaitForConversion();
+
+	TArray<FImGuiDrawList>& DrawLists = DrawFrames[FrontFrame ^ 1].DrawLists;
+
 	if (DrawData && DrawData->CmdListsCount > 0)
 	{
 #if (ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 4)
@@ -264,6 +350,43 @@ void FImGuiContextProxy::UpdateDrawData(ImDrawData* DrawData)
 		// If we are not rendering then this might be a good moment to empty the array.
 		DrawLists.Empty();
 	}
+
+	if (IsPaintDecoupled())
+	{
+		// Paint swaps the back buffer in, once its conversion is done.
+		bBackFrameReady = true;
+		LaunchConversion();
+	}
+	else
+	{
+		FrontFrame ^= 1;
+		bBackFrameReady = false;
+	}
+}
+
+void FImGuiContextProxy::LaunchConversion()
+{
+#if !ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+	// Without a transform from paint there is nothing to convert with. Paint converts on its own when it first gets
+	// the data.
+	if (bHasPaintTransform)
+	{
+		ConversionTask = FFunctionGraphTask::CreateAndDispatchWhenReady(
+			[&Frame = DrawFrames[FrontFrame ^ 1], Transform = PaintTransform]()
+			{
+				FImGuiDrawListCache::UpdateAll(Frame.DrawListCaches, Frame.DrawLists, Transform);
+			}, TStatId{}, nullptr, ENamedThreads::AnyBackgroundThreadNormalTask);
+	}
+#endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+}
+
+void FImGuiContextProxy::WaitForConversion()
+{
+	if (ConversionTask.IsValid())
+	{
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(ConversionTask);
+		ConversionTask = nullptr;
+	}
 }
 
 void FImGuiContextProxy::BroadcastWorldEarlyDebug()
@@ -6,6 +6,7 @@
 #include "ImGuiInputState.h"
 #include "Utilities/WorldContextIndex.h"
 
+#include <Async/TaskGraphInterfaces.h>
 #include <GenericPlatform/ICursor.h>
 
 #include <imgui.h>
@@ -29,7 +30,17 @@ public:
 	const FString& GetName() const { return Name; }
 
 	// Get draw data from the last frame.
-	const TArray<FImGuiDrawList>& GetDrawData() const { return DrawLists; }
+	const TArray<FImGuiDrawList>& GetDrawData() const { return DrawFrames[FrontFrame].DrawLists; }
+
+	// Whether frames end at a fixed point after the world tick instead of during paint, with their draw data converted
+	// for Slate on a worker thread (see 'ImGui.DecoupledPaint').
+	static bool IsPaintDecoupled();
+
+	// Wait for the draw data converted on a worker thread and make them the ones returned by GetDrawData. Used only
+	// when paint is decoupled.
+	// @param Transform - Transform used to paint this context, next frames are converted with it
+	// @returns Converted draw lists matching GetDrawData, up to date if the transform did not change since conversion
+	TArray<FImGuiDrawListCache>& SwapConvertedDrawData(const FTransform2D& Transform);
 
 	// Get input state used by this context.
 	FImGuiInputState& GetInputState() { return InputState; }
@@ -65,6 +76,10 @@ public:
 	// Cursor type desired by this context (updated once per frame during context update).
 	EMouseCursor::Type GetMouseCursor() const { return MouseCursor;  }
 
+	// Keep this context rendering at the full frame rate for the next frame, even if it would be throttled as idle
+	// (see 'ImGui.IdleUpdateRate'). Needed by controls that change without input, like live plots.
+	void RequestKeepAlive() { bKeepAliveRequested = true; }
+
 	// Internal draw event used to draw module's examples and debug widgets. Unlike the delegates container, it is not
 	// passed when the module is reloaded, so all objects that are unloaded with the module should register here.
 	FSimpleMulticastDelegate& OnDraw() { return DrawEvent; }
@@ -80,11 +95,23 @@ public:
 
 private:
 
+	// Whether nothing can change in this context's output: no input, active items or keep-alive requests.
+	bool IsIdle() const;
+
 	void BeginFrame(float DeltaTime = 1.f / 60.f);
 	void EndFrame();
 
+	// End the frame without rendering it, keeping the last draw data.
+	void DiscardFrame();
+
 	void UpdateDrawData(ImDrawData* DrawData);
 
+	// Convert back buffer draw data for Slate on a worker thread.
+	void LaunchConversion();
+
+	// Wait until conversion of the back buffer is finished, so it can be read or written again.
+	void WaitForConversion();
+
 	void BroadcastWorldEarlyDebug();
 	void BroadcastMultiContextEarlyDebug();
 
@@ -103,10 +130,32 @@ private:
 	bool bIsFrameStarted = false;
 	bool bIsDrawEarlyDebugCalled = false;
 	bool bIsDrawDebugCalled = false;
+	bool bKeepAliveRequested = false;
+
+	// Whether input events were queued when the current frame started.
+	bool bFrameHadInput = false;
+
+	// Time since the last rendered frame, longer than one engine frame when idle frames are throttled.
+	float TimeSinceRender = 0.f;
 
 	FImGuiInputState InputState;
 
-	TArray<FImGuiDrawList> DrawLists;
+	// Draw data of a finished frame, with their conversion for Slate if paint is decoupled.
+	struct FDrawFrame
+	{
+		TArray<FImGuiDrawList> DrawLists;
+		TArray<FImGuiDrawListCache> DrawListCaches;
+	};
+
+	// Frames end in the back buffer, paint reads the front one. When paint is decoupled, the back buffer is converted
+	// on a worker thread and swapped in by paint, otherwise it is swapped in as soon as the frame ends.
+	FDrawFrame DrawFrames[2];
+	int32 FrontFrame = 0;
+	bool bBackFrameReady = false;
+
+	FGraphEventRef ConversionTask;
+	FTransform2D PaintTransform;
+	bool bHasPaintTransform = false;
 
 	FString Name;
 	int32 ContextIndex = Utilities::INVALID_CONTEXT_INDEX;
@@ -2,69 +2,492 @@
 
 #include "ImGuiDrawData.h"
 
+#include <Async/ParallelFor.h>
+#include <Hash/CityHash.h>
+#include <HAL/IConsoleManager.h>
+#include <Math/RandomStream.h>
 
-#if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
-void FImGuiDrawList::CopyVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FTransform2D& Transform, const FSlateRotatedRect& VertexClippingRect) const
-#else
-void FImGuiDrawList::CopyVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FTransform2D& Transform) const
-#endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+
+// Vectorized vertex conversion needs the UE5 float math types.
+#define IMGUI_VECTORIZED_VERTEX_COPY (!ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API && !ENGINE_COMPATIBILITY_LEGACY_VECTOR2F)
+
+// With the default ImU32 layout (R in the lowest byte) ImGui colors convert to FColor (B in the lowest byte on little-endian
+// platforms) by swapping R and B, which can be done for four colors at once.
+#define IMGUI_SWIZZLE_PACKED_COLORS (PLATFORM_LITTLE_ENDIAN && IM_COL32_R_SHIFT == 0 && IM_COL32_G_SHIFT == 8 \
+	&& IM_COL32_B_SHIFT == 16 && IM_COL32_A_SHIFT == 24)
+
+namespace CVars
 {
-	// Reset and reserve space in destination buffer.
-#if (ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 4)
-	OutVertexBuffer.SetNumUninitialized(ImGuiVertexBuffer.Size, EAllowShrinking::No);
-#else
-	OutVertexBuffer.SetNumUninitialized(ImGuiVertexBuffer.Size, false);
-#endif
+	TAutoConsoleVariable<int> ParallelConversionThreshold(TEXT("ImGui.ParallelConversionThreshold"), 16384,
+		TEXT("Minimum number of vertices in changed draw lists of a context, to convert those lists for Slate in parallel.\n")
+		TEXT("Below that, task overhead is larger than the conversion. A negative value disables parallel conversion."),
+		ECVF_Default);
+}
 
-	// Transform and copy vertex data.
-	for (int Idx = 0; Idx < ImGuiVertexBuffer.Size; Idx++)
+#if !ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+namespace
+{
+#if !IMGUI_VECTORIZED_VERTEX_COPY || !UE_BUILD_SHIPPING
+	// Reference conversion: one vertex at a time, transformed through FVector2D.
+	void CopyVerticesScalar(const ImDrawVert* Src, FSlateVertex* Dst, int32 Num, const FTransform2D& Transform)
 	{
-		const ImDrawVert& ImGuiVertex = ImGuiVertexBuffer[Idx];
-		FSlateVertex& SlateVertex = OutVertexBuffer[Idx];
+		for (int Idx = 0; Idx < Num; Idx++)
+		{
+			const ImDrawVert& ImGuiVertex = Src[Idx];
+			FSlateVertex& SlateVertex = Dst[Idx];
 
-		// Final UV is calculated in shader as XY * ZW, so we need set all components.
-		SlateVertex.TexCoords[0] = ImGuiVertex.uv.x;
-		SlateVertex.TexCoords[1] = ImGuiVertex.uv.y;
-		SlateVertex.TexCoords[2] = SlateVertex.TexCoords[3] = 1.f;
+			// Final UV is calculated in shader as XY * ZW, so we need set all components.
+			SlateVertex.TexCoords[0] = ImGuiVertex.uv.x;
+			SlateVertex.TexCoords[1] = ImGuiVertex.uv.y;
+			SlateVertex.TexCoords[2] = SlateVertex.TexCoords[3] = 1.f;
 
-#if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
-		const FVector2D VertexPosition = Transform.TransformPoint(ImGuiInterops::ToVector2D(ImGuiVertex.pos));
-		SlateVertex.Position[0] = VertexPosition.X;
-		SlateVertex.Position[1] = VertexPosition.Y;
-		SlateVertex.ClipRect = VertexClippingRect;
-#else
 #if ENGINE_COMPATIBILITY_LEGACY_VECTOR2F
-		SlateVertex.Position = Transform.TransformPoint(ImGuiInterops::ToVector2D(ImGuiVertex.pos));
+			SlateVertex.Position = Transform.TransformPoint(ImGuiInterops::ToVector2D(ImGuiVertex.pos));
 #else
-		SlateVertex.Position = (FVector2f)Transform.TransformPoint(ImGuiInterops::ToVector2D(ImGuiVertex.pos));
+			SlateVertex.Position = (FVector2f)Transform.TransformPoint(ImGuiInterops::ToVector2D(ImGuiVertex.pos));
 #endif // ENGINE_COMPATIBILITY_LEGACY_VECTOR2F
-#endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
 
-		// Unpack ImU32 color.
-		SlateVertex.Color = ImGuiInterops::UnpackImU32Color(ImGuiVertex.col);
+			// Unpack ImU32 color.
+			SlateVertex.Color = ImGuiInterops::UnpackImU32Color(ImGuiVertex.col);
+		}
 	}
+#endif // !IMGUI_VECTORIZED_VERTEX_COPY || !UE_BUILD_SHIPPING
+
+#if IMGUI_VECTORIZED_VERTEX_COPY
+	FORCEINLINE uint32 SwizzleColor(ImU32 Color)
+	{
+#if IMGUI_SWIZZLE_PACKED_COLORS
+		return (Color & 0xFF00FF00) | ((Color << 16) & 0x00FF0000) | ((Color >> 16) & 0x000000FF);
+#else
+		return ImGuiInterops::UnpackImU32Color(Color).DWColor();
+#endif // IMGUI_SWIZZLE_PACKED_COLORS
+	}
+
+	// Positions end up in floats anyway, so they are transformed in float, four vertices at a time (SSE or NEON, with
+	// the engine's scalar fallback elsewhere). Colors of the same four vertices are unpacked together.
+	void CopyVerticesVectorized(const ImDrawVert* Src, FSlateVertex* Dst, int32 Num, const FTransform2D& Transform)
+	{
+		// Point transform is: X' = X * A + Y * C + TX, Y' = X * B + Y * D + TY.
+		const FVector2f AxisX{ Transform.TransformVector(FVector2D{ 1.0, 0.0 }) };
+		const FVector2f AxisY{ Transform.TransformVector(FVector2D{ 0.0, 1.0 }) };
+		const FVector2f Translation{ Transform.GetTranslation() };
+
+		const VectorRegister4Float MA = VectorSetFloat1(AxisX.X);
+		const VectorRegister4Float MB = VectorSetFloat1(AxisX.Y);
+		const VectorRegister4Float MC = VectorSetFloat1(AxisY.X);
+		const VectorRegister4Float MD = VectorSetFloat1(AxisY.Y);
+		const VectorRegister4Float TX = VectorSetFloat1(Translation.X);
+		const VectorRegister4Float TY = VectorSetFloat1(Translation.Y);
+
+#if IMGUI_SWIZZLE_PACKED_COLORS
+		const VectorRegister4Int GreenAlphaMask = VectorIntSet1(static_cast<int32>(0xFF00FF00));
+		const VectorRegister4Int RedMask = VectorIntSet1(0x00FF0000);
+		const VectorRegister4Int BlueMask = VectorIntSet1(0x000000FF);
+#endif // IMGUI_SWIZZLE_PACKED_COLORS
+
+		int32 Idx = 0;
+		for (; Idx + 4 <= Num; Idx += 4)
+		{
+			const ImDrawVert* const V = Src + Idx;
+
+			const VectorRegister4Float X = MakeVectorRegister(V[0].pos.x, V[1].pos.x, V[2].pos.x, V[3].pos.x);
+			const VectorRegister4Float Y = MakeVectorRegister(V[0].pos.y, V[1].pos.y, V[2].pos.y, V[3].pos.y);
+
+			alignas(16) float OutX[4];
+			alignas(16) float OutY[4];
+			VectorStoreAligned(VectorMultiplyAdd(Y, MC, VectorMultiplyAdd(X, MA, TX)), OutX);
+			VectorStoreAligned(VectorMultiplyAdd(Y, MD, VectorMultiplyAdd(X, MB, TY)), OutY);
+
+			alignas(16) uint32 OutColors[4];
+#if IMGUI_SWIZZLE_PACKED_COLORS
+			const VectorRegister4Int Colors = MakeVectorRegisterInt(static_cast<int32>(V[0].col), static_cast<int32>(V[1].col),
+				static_cast<int32>(V[2].col), static_cast<int32>(V[3].col));
+			const VectorRegister4Int Swizzled = VectorIntOr(VectorIntAnd(Colors, GreenAlphaMask),
+				VectorIntOr(VectorIntAnd(VectorShiftLeftImm(Colors, 16), RedMask), VectorIntAnd(VectorShiftRightImmLogical(Colors, 16), BlueMask)));
+			VectorIntStoreAligned(Swizzled, OutColors);
+#else
+			for (int Lane = 0; Lane < 4; Lane++)
+			{
+				OutColors[Lane] = SwizzleColor(V[Lane].col);
+			}
+#endif // IMGUI_SWIZZLE_PACKED_COLORS
+
+			for (int Lane = 0; Lane < 4; Lane++)
+			{
+				FSlateVertex& SlateVertex = Dst[Idx + Lane];
+
+				// Final UV is calculated in shader as XY * ZW, so we need set all components.
+				VectorStore(MakeVectorRegister(V[Lane].uv.x, V[Lane].uv.y, 1.f, 1.f), SlateVertex.TexCoords);
+				SlateVertex.Position = FVector2f{ OutX[Lane], OutY[Lane] };
+				SlateVertex.Color.DWColor() = OutColors[Lane];
+			}
+		}
+
+		// Remaining vertices with the same float math.
+		for (; Idx < Num; Idx++)
+		{
+			const ImDrawVert& ImGuiVertex = Src[Idx];
+			FSlateVertex& SlateVertex = Dst[Idx];
+
+			SlateVertex.TexCoords[0] = ImGuiVertex.uv.x;
+			SlateVertex.TexCoords[1] = ImGuiVertex.uv.y;
+			SlateVertex.TexCoords[2] = SlateVertex.TexCoords[3] = 1.f;
+			SlateVertex.Position = FVector2f{ ImGuiVertex.pos.x * AxisX.X + ImGuiVertex.pos.y * AxisY.X + Translation.X,
+				ImGuiVertex.pos.x * AxisX.Y + ImGuiVertex.pos.y * AxisY.Y + Translation.Y };
+			SlateVertex.Color.DWColor() = SwizzleColor(ImGuiVertex.col);
+		}
+	}
+#endif // IMGUI_VECTORIZED_VERTEX_COPY
 }
+#endif // !ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
 
-void FImGuiDrawList::CopyIndexData(TArray<SlateIndex>& OutIndexBuffer, const int32 StartIndex, const int32 NumElements) const
+#if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+namespace
 {
+	void CopyVerticesLegacy(const ImDrawVert* Src, FSlateVertex* Dst, int32 Num, const FTransform2D& Transform, const FSlateRotatedRect& VertexClippingRect)
+	{
+		for (int Idx = 0; Idx < Num; Idx++)
+		{
+			const ImDrawVert& ImGuiVertex = Src[Idx];
+			FSlateVertex& SlateVertex = Dst[Idx];
+
+			// Final UV is calculated in shader as XY * ZW, so we need set all components.
+			SlateVertex.TexCoords[0] = ImGuiVertex.uv.x;
+			SlateVertex.TexCoords[1] = ImGuiVertex.uv.y;
+			SlateVertex.TexCoords[2] = SlateVertex.TexCoords[3] = 1.f;
+
+			const FVector2D VertexPosition = Transform.TransformPoint(ImGuiInterops::ToVector2D(ImGuiVertex.pos));
+			SlateVertex.Position[0] = VertexPosition.X;
+			SlateVertex.Position[1] = VertexPosition.Y;
+			SlateVertex.ClipRect = VertexClippingRect;
+
+			// Unpack ImU32 color.
+			SlateVertex.Color = ImGuiInterops::UnpackImU32Color(ImGuiVertex.col);
+		}
+	}
+}
+
+void FImGuiDrawList::CopyBatchVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FTransform2D& Transform, const FSlateRotatedRect& VertexClippingRect, int BatchNb) const
+{
+	const FImGuiDrawBatch& Batch = Batches[BatchNb];
+
+	OutVertexBuffer.SetNumUninitialized(Batch.NumVertices, false);
+	CopyVerticesLegacy(ImGuiVertexBuffer.Data + Batch.FirstVertex, OutVertexBuffer.GetData(), Batch.NumVertices, Transform, VertexClippingRect);
+}
+#else
+namespace
+{
+	FORCEINLINE void CopyVertices(const ImDrawVert* Src, FSlateVertex* Dst, int32 Num, const FTransform2D& Transform)
+	{
+#if IMGUI_VECTORIZED_VERTEX_COPY
+		CopyVerticesVectorized(Src, Dst, Num, Transform);
+#else
+		CopyVerticesScalar(Src, Dst, Num, Transform);
+#endif // IMGUI_VECTORIZED_VERTEX_COPY
+	}
+}
+
+void FImGuiDrawList::CopyBatchVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FTransform2D& Transform, int BatchNb) const
+{
+	const FImGuiDrawBatch& Batch = Batches[BatchNb];
+
 #if (ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 4)
-	OutIndexBuffer.SetNumUninitialized(NumElements, EAllowShrinking::No);
+	OutVertexBuffer.SetNumUninitialized(Batch.NumVertices, EAllowShrinking::No);
 #else
-	OutIndexBuffer.SetNumUninitialized(NumElements, false);
+	OutVertexBuffer.SetNumUninitialized(Batch.NumVertices, false);
 #endif
 
-	// Copy elements (slow copy because of different sizes of ImDrawIdx and SlateIndex and because SlateIndex can
-	// have different size on different platforms).
-	for (int i = 0; i < NumElements; i++)
+	CopyVertices(ImGuiVertexBuffer.Data + Batch.FirstVertex, OutVertexBuffer.GetData(), Batch.NumVertices, Transform);
+}
+#endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+
+namespace
+{
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+	// Load four 16-bit indices widened to 32 bits.
+	FORCEINLINE VectorRegister4Int LoadWidenedIndices(const uint16* Src)
+	{
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+		return vreinterpretq_s32_u32(vmovl_u16(vld1_u16(Src)));
+#else
+		return _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Src)), _mm_setzero_si128());
+#endif // PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+	}
+
+	FORCEINLINE VectorRegister4Int LoadWidenedIndices(const uint32* Src)
 	{
-		OutIndexBuffer[i] = ImGuiIndexBuffer[StartIndex + i];
+		return VectorIntLoad(Src);
+	}
+#endif // PLATFORM_ENABLE_VECTORINTRINSICS
+
+	// Copy indices subtracting base vertex from each of them. Indices of the same width without a base vertex are copied
+	// as memory, others are widened and rebased four at a time.
+	template<typename SrcIndexType>
+	void CopyIndices(const SrcIndexType* Src, SlateIndex* Dst, int32 Num, int32 BaseVertex)
+	{
+		if constexpr (sizeof(SrcIndexType) == sizeof(SlateIndex))
+		{
+			if (BaseVertex == 0)
+			{
+				FMemory::Memcpy(Dst, Src, Num * sizeof(SlateIndex));
+				return;
+			}
+		}
+
+		int32 i = 0;
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+		if constexpr (sizeof(SlateIndex) == sizeof(uint32))
+		{
+			const VectorRegister4Int Base = VectorIntSet1(BaseVertex);
+			for (; i + 4 <= Num; i += 4)
+			{
+				VectorIntStore(VectorIntSubtract(LoadWidenedIndices(Src + i), Base), Dst + i);
+			}
+		}
+#endif // PLATFORM_ENABLE_VECTORINTRINSICS
+
+		for (; i < Num; i++)
+		{
+			Dst[i] = static_cast<SlateIndex>(Src[i] - BaseVertex);
+		}
 	}
 }
 
+void FImGuiDrawList::CopyBatchIndexData(TArray<SlateIndex>& OutIndexBuffer, int BatchNb) const
+{
+	const FImGuiDrawBatch& Batch = Batches[BatchNb];
+
+#if (ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 4)
+	OutIndexBuffer.SetNumUninitialized(Batch.NumIndices, EAllowShrinking::No);
+#else
+	OutIndexBuffer.SetNumUninitialized(Batch.NumIndices, false);
+#endif
+
+	// Batch vertices are copied starting from its first vertex, so indices need to be rebased.
+	CopyIndices(ImGuiIndexBuffer.Data + Batch.FirstIndex, OutIndexBuffer.GetData(), Batch.NumIndices, Batch.FirstVertex);
+}
+
 void FImGuiDrawList::TransferDrawData(ImDrawList& Src)
 {
 	// Move data from source to this list.
 	Src.CmdBuffer.swap(ImGuiCommandBuffer);
 	Src.IdxBuffer.swap(ImGuiIndexBuffer);
 	Src.VtxBuffer.swap(ImGuiVertexBuffer);
+
+	BuildBatches();
+
+	bContentHashValid = false;
+}
+
+uint64 FImGuiDrawList::GetContentHash() const
+{
+	if (!bContentHashValid)
+	{
+		// Batches carry all the command state that we use, so together with vertices and indices they identify the content.
+		ContentHash = CityHash64(reinterpret_cast<const char*>(ImGuiVertexBuffer.Data), ImGuiVertexBuffer.size_in_bytes());
+		ContentHash = CityHash64WithSeed(reinterpret_cast<const char*>(ImGuiIndexBuffer.Data), ImGuiIndexBuffer.size_in_bytes(), ContentHash);
+		ContentHash = CityHash64WithSeed(reinterpret_cast<const char*>(Batches.GetData()), Batches.Num() * sizeof(FImGuiDrawBatch), ContentHash);
+		bContentHashValid = true;
+	}
+	return ContentHash;
+}
+
+void FImGuiDrawList::BuildBatches()
+{
+	Batches.Reset();
+
+	int32 IndexOffset = 0;
+	for (const ImDrawCmd& Command : ImGuiCommandBuffer)
+	{
+		const int32 FirstIndex = IndexOffset;
+		const int32 NumIndices = static_cast<int32>(Command.ElemCount);
+		IndexOffset += NumIndices;
+
+		if (NumIndices == 0)
+		{
+			continue;
+		}
+
+		// Vertex range used by this command.
+		int32 MinVertex = ImGuiIndexBuffer[FirstIndex];
+		int32 MaxVertex = MinVertex;
+		for (int32 i = FirstIndex + 1; i < FirstIndex + NumIndices; i++)
+		{
+			MinVertex = FMath::Min<int32>(MinVertex, ImGuiIndexBuffer[i]);
+			MaxVertex = FMath::Max<int32>(MaxVertex, ImGuiIndexBuffer[i]);
+		}
+
+		// Commands are consecutive in the index buffer, so ones with the same state can simply be merged.
+		if (Batches.Num() > 0)
+		{
+			FImGuiDrawBatch& Last = Batches.Last();
+			if (Last.TextureId == Command.TextureId && FMemory::Memcmp(&Last.ClipRect, &Command.ClipRect, sizeof(ImVec4)) == 0)
+			{
+				const int32 LastVertex = FMath::Max(Last.FirstVertex + Last.NumVertices - 1, MaxVertex);
+				Last.FirstVertex = FMath::Min(Last.FirstVertex, MinVertex);
+				Last.NumVertices = LastVertex - Last.FirstVertex + 1;
+				Last.NumIndices += NumIndices;
+				continue;
+			}
+		}
+
+		Batches.Add({ FirstIndex, NumIndices, MinVertex, MaxVertex - MinVertex + 1, Command.ClipRect, Command.TextureId });
+	}
+}
+
+bool FImGuiDrawListCache::IsUpToDate(const FImGuiDrawList& DrawList, const FTransform2D& InTransform) const
+{
+#if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+	// Vertices carry the clipping rectangle, so they are always converted.
+	return false;
+#else
+	return bValid && ContentHash == DrawList.GetContentHash() && Transform == InTransform;
+#endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+}
+
+#if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+void FImGuiDrawListCache::Update(const FImGuiDrawList& DrawList, const FTransform2D& InTransform, const FSlateRotatedRect& VertexClippingRect)
+#else
+void FImGuiDrawListCache::Update(const FImGuiDrawList& DrawList, const FTransform2D& InTransform)
+#endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+{
+	const bool bContentChanged = !bValid || ContentHash != DrawList.GetContentHash();
+
+#if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+	// Vertices carry the clipping rectangle, so they are always converted.
+	const bool bVerticesChanged = true;
+#else
+	const bool bVerticesChanged = bContentChanged || !(Transform == InTransform);
+#endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+
+	if (bContentChanged)
+	{
+		Batches.SetNum(DrawList.NumBatches());
+		for (int BatchNb = 0; BatchNb < Batches.Num(); BatchNb++)
+		{
+			DrawList.CopyBatchIndexData(Batches[BatchNb].Indices, BatchNb);
+		}
+		ContentHash = DrawList.GetContentHash();
+	}
+
+	if (bVerticesChanged)
+	{
+		for (int BatchNb = 0; BatchNb < Batches.Num(); BatchNb++)
+		{
+#if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+			DrawList.CopyBatchVertexData(Batches[BatchNb].Vertices, InTransform, VertexClippingRect, BatchNb);
+#else
+			DrawList.CopyBatchVertexData(Batches[BatchNb].Vertices, InTransform, BatchNb);
+#endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+		}
+		Transform = InTransform;
+	}
+
+	bValid = true;
+}
+
+#if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+void FImGuiDrawListCache::UpdateAll(TArray<FImGuiDrawListCache>& Caches, const TArray<FImGuiDrawList>& DrawLists, const FTransform2D& Transform,
+	const FSlateRotatedRect& VertexClippingRect)
+#else
+void FImGuiDrawListCache::UpdateAll(TArray<FImGuiDrawListCache>& Caches, const TArray<FImGuiDrawList>& DrawLists, const FTransform2D& Transform)
+#endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+{
+	// Allocate all outputs upfront, so each list writes only to its own cache.
+	Caches.SetNum(DrawLists.Num());
+
+	auto UpdateList = [&](int32 ListNb)
+	{
+#if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+		Caches[ListNb].Update(DrawLists[ListNb], Transform, VertexClippingRect);
+#else
+		Caches[ListNb].Update(DrawLists[ListNb], Transform);
+#endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+	};
+
+	// Only lists that changed need converting, so only their vertices count towards the threshold. A static UI is
+	// then checked without any tasks.
+	TArray<int32, TInlineAllocator<32>> DirtyLists;
+	int32 DirtyVertices = 0;
+	for (int ListNb = 0; ListNb < DrawLists.Num(); ListNb++)
+	{
+		if (!Caches[ListNb].IsUpToDate(DrawLists[ListNb], Transform))
+		{
+			DirtyLists.Add(ListNb);
+			DirtyVertices += DrawLists[ListNb].NumVertices();
+		}
+	}
+
+	const int32 Threshold = CVars::ParallelConversionThreshold.GetValueOnAnyThread();
+	if (DirtyLists.Num() > 1 && Threshold >= 0 && DirtyVertices >= Threshold)
+	{
+		// Lists differ a lot in size (one large window next to many small ones), so let workers pick them one by one.
+		ParallelFor(DirtyLists.Num(), [&](int32 DirtyNb) { UpdateList(DirtyLists[DirtyNb]); }, EParallelForFlags::Unbalanced);
+	}
+	else
+	{
+		for (const int32 ListNb : DirtyLists)
+		{
+			UpdateList(ListNb);
+		}
+	}
+}
+
+#if IMGUI_VECTORIZED_VERTEX_COPY && !UE_BUILD_SHIPPING
+namespace
+{
+	DEFINE_LOG_CATEGORY_STATIC(LogImGuiDrawData, Log, All);
+
+	// Converts a panel-sized vertex buffer with the reference and the vectorized loop and logs timings of both.
+	FAutoConsoleCommand VertexConversionBenchmarkCommand(
+		TEXT("ImGui.Benchmark.VertexConversion"),
+		TEXT("Compares scalar and vectorized ImGui to Slate vertex conversion. Optional argument: number of vertices (default 200000)."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const int32 NumVertices = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 200000;
+			constexpr int32 NumIterations = 20;
+
+			FRandomStream Random{ 1234 };
+			TArray<ImDrawVert> Source;
+			Source.SetNumUninitialized(NumVertices);
+			for (ImDrawVert& Vertex : Source)
+			{
+				Vertex.pos = ImVec2{ Random.FRandRange(0.f, 1920.f), Random.FRandRange(0.f, 1080.f) };
+				Vertex.uv = ImVec2{ Random.FRand(), Random.FRand() };
+				Vertex.col = static_cast<ImU32>(Random.GetUnsignedInt());
+			}
+
+			const FTransform2D Transform{ FScale2D{ 1.25 }, FVector2D{ 37.5, 12.0 } };
+			TArray<FSlateVertex> ScalarOutput;
+			TArray<FSlateVertex> VectorizedOutput;
+			ScalarOutput.SetNumUninitialized(NumVertices);
+			VectorizedOutput.SetNumUninitialized(NumVertices);
+
+			double ScalarSeconds = 0.0;
+			double VectorizedSeconds = 0.0;
+			for (int Iteration = 0; Iteration < NumIterations; Iteration++)
+			{
+				double StartTime = FPlatformTime::Seconds();
+				CopyVerticesScalar(Source.GetData(), ScalarOutput.GetData(), NumVertices, Transform);
+				ScalarSeconds += FPlatformTime::Seconds() - StartTime;
+
+				StartTime = FPlatformTime::Seconds();
+				CopyVerticesVectorized(Source.GetData(), VectorizedOutput.GetData(), NumVertices, Transform);
+				VectorizedSeconds += FPlatformTime::Seconds() - StartTime;
+			}
+
+			// Both paths must agree, up to float rounding of the positions.
+			float MaxPositionError = 0.f;
+			int32 ColorMismatches = 0;
+			for (int32 Idx = 0; Idx < NumVertices; Idx++)
+			{
+				MaxPositionError = FMath::Max(MaxPositionError, (ScalarOutput[Idx].Position - VectorizedOutput[Idx].Position).GetAbsMax());
+				ColorMismatches += ScalarOutput[Idx].Color != VectorizedOutput[Idx].Color ? 1 : 0;
+			}
+
+			UE_LOG(LogImGuiDrawData, Log, TEXT("%d vertices: scalar %.3f ms, vectorized %.3f ms (x%.2f), max position error %g, %d color mismatches"),
+				NumVertices, ScalarSeconds * 1000.0 / NumIterations, VectorizedSeconds * 1000.0 / NumIterations,
+				ScalarSeconds / FMath::Max(VectorizedSeconds, UE_SMALL_NUMBER), MaxPositionError, ColorMismatches);
+		}));
 }
+#endif // IMGUI_VECTORIZED_VERTEX_COPY && !UE_BUILD_SHIPPING
@@ -18,51 +18,140 @@ struct FImGuiDrawCommand
 	TextureIndex TextureId;
 };
 
+// Consecutive ImGui draw commands that share texture and clipping rectangle, together with the range of vertices they
+// use. Each batch is submitted to Slate as one element, with only its own vertices.
+struct FImGuiDrawBatch
+{
+	int32 FirstIndex;
+	int32 NumIndices;
+	int32 FirstVertex;
+	int32 NumVertices;
+	ImVec4 ClipRect;
+	ImTextureID TextureId;
+};
+
 // Wraps raw ImGui draw list data in utilities that transform them for Slate.
 class FImGuiDrawList
 {
 public:
 
-	// Get the number of draw commands in this list.
-	FORCEINLINE int NumCommands() const { return ImGuiCommandBuffer.Size; }
+	// Get the number of vertices in this list.
+	FORCEINLINE int NumVertices() const { return ImGuiVertexBuffer.Size; }
 
-	// Get the draw command by number.
-	// @param CommandNb - Number of draw command
+	// Get the number of draw batches in this list.
+	FORCEINLINE int NumBatches() const { return Batches.Num(); }
+
+	// Get the draw batch by number, as a draw command covering all of its elements.
+	// @param BatchNb - Number of draw batch
 	// @param Transform - Transform to apply to clipping rectangle
 	// @returns Draw command data
-	FImGuiDrawCommand GetCommand(int CommandNb, const FTransform2D& Transform) const
+	FImGuiDrawCommand GetBatch(int BatchNb, const FTransform2D& Transform) const
 	{
-		const ImDrawCmd& ImGuiCommand = ImGuiCommandBuffer[CommandNb];
-		return { ImGuiCommand.ElemCount, TransformRect(Transform, ImGuiInterops::ToSlateRect(ImGuiCommand.ClipRect)),
-			ImGuiInterops::ToTextureIndex(ImGuiCommand.TextureId) };
+		const FImGuiDrawBatch& Batch = Batches[BatchNb];
+		return { static_cast<uint32>(Batch.NumIndices), TransformRect(Transform, ImGuiInterops::ToSlateRect(Batch.ClipRect)),
+			ImGuiInterops::ToTextureIndex(Batch.TextureId) };
 	}
 
 #if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
-	// Transform and copy vertex data to target buffer (old data in the target buffer are replaced).
+	// Transform and copy vertices used by a draw batch to target buffer (old data in the target buffer are replaced).
 	// @param OutVertexBuffer - Destination buffer
 	// @param Transform - Transform to apply to all vertices
 	// @param VertexClippingRect - Clipping rectangle for transformed Slate vertices
-	void CopyVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FTransform2D& Transform, const FSlateRotatedRect& VertexClippingRect) const;
+	// @param BatchNb - Number of draw batch
+	void CopyBatchVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FTransform2D& Transform, const FSlateRotatedRect& VertexClippingRect, int BatchNb) const;
 #else
-	// Transform and copy vertex data to target buffer (old data in the target buffer are replaced).
+	// Transform and copy vertices used by a draw batch to target buffer (old data in the target buffer are replaced).
 	// @param OutVertexBuffer - Destination buffer
 	// @param Transform - Transform to apply to all vertices
-	void CopyVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FTransform2D& Transform) const;
+	// @param BatchNb - Number of draw batch
+	void CopyBatchVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FTransform2D& Transform, int BatchNb) const;
 #endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
 
-	// Transform and copy index data to target buffer (old data in the target buffer are replaced).
-	// Internal index buffer contains enough data to match the sum of NumElements from all draw commands.
+	// Copy indices of a draw batch to target buffer (old data in the target buffer are replaced). Indices are rebased to
+	// the vertices copied by CopyBatchVertexData.
 	// @param OutIndexBuffer - Destination buffer
-	// @param StartIndex - Start copying source data starting from this index
-	// @param NumElements - How many elements we want to copy
-	void CopyIndexData(TArray<SlateIndex>& OutIndexBuffer, const int32 StartIndex, const int32 NumElements) const;
+	// @param BatchNb - Number of draw batch
+	void CopyBatchIndexData(TArray<SlateIndex>& OutIndexBuffer, int BatchNb) const;
 
 	// Transfers data from ImGui source list to this object. Leaves source cleared.
 	void TransferDrawData(ImDrawList& Src);
 
+	// Get the hash of vertices, indices and batches transferred with the last TransferDrawData. It is computed on first
+	// use, so its cost is paid where draw data are converted and not where they are transferred.
+	uint64 GetContentHash() const;
+
 private:
 
+	// Merge commands into batches and find vertex ranges used by them.
+	void BuildBatches();
+
+	TArray<FImGuiDrawBatch> Batches;
+
 	ImVector<ImDrawCmd> ImGuiCommandBuffer;
 	ImVector<ImDrawIdx> ImGuiIndexBuffer;
 	ImVector<ImDrawVert> ImGuiVertexBuffer;
+
+	mutable uint64 ContentHash = 0;
+	mutable bool bContentHashValid = false;
+};
+
+// Slate vertices and indices of all batches of a draw list, retained between frames. Indices are only converted again
+// when the list content changes and vertices when the content or the transform changes, so a static UI costs one hash
+// per list and frame.
+class FImGuiDrawListCache
+{
+public:
+
+#if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+	// Bring converted data up to date with the draw list.
+	// @param DrawList - Draw list to convert
+	// @param Transform - Transform to apply to all vertices
+	// @param VertexClippingRect - Clipping rectangle for transformed Slate vertices
+	void Update(const FImGuiDrawList& DrawList, const FTransform2D& Transform, const FSlateRotatedRect& VertexClippingRect);
+#else
+	// Bring converted data up to date with the draw list.
+	// @param DrawList - Draw list to convert
+	// @param Transform - Transform to apply to all vertices
+	void Update(const FImGuiDrawList& DrawList, const FTransform2D& Transform);
+#endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+
+#if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+	// Bring converted data of all draw lists up to date. Lists are independent, so when changed lists have enough
+	// vertices they are converted in parallel (see 'ImGui.ParallelConversionThreshold').
+	// @param Caches - Caches to update, resized to one per draw list
+	// @param DrawLists - Draw lists to convert
+	// @param Transform - Transform to apply to all vertices
+	// @param VertexClippingRect - Clipping rectangle for transformed Slate vertices
+	static void UpdateAll(TArray<FImGuiDrawListCache>& Caches, const TArray<FImGuiDrawList>& DrawLists, const FTransform2D& Transform,
+		const FSlateRotatedRect& VertexClippingRect);
+#else
+	// Bring converted data of all draw lists up to date. Lists are independent, so when changed lists have enough
+	// vertices they are converted in parallel (see 'ImGui.ParallelConversionThreshold').
+	// @param Caches - Caches to update, resized to one per draw list
+	// @param DrawLists - Draw lists to convert
+	// @param Transform - Transform to apply to all vertices
+	static void UpdateAll(TArray<FImGuiDrawListCache>& Caches, const TArray<FImGuiDrawList>& DrawLists, const FTransform2D& Transform);
+#endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+
+	// Get converted vertices of a draw batch.
+	FORCEINLINE const TArray<FSlateVertex>& GetVertices(int BatchNb) const { return Batches[BatchNb].Vertices; }
+
+	// Get converted indices of a draw batch.
+	FORCEINLINE const TArray<SlateIndex>& GetIndices(int BatchNb) const { return Batches[BatchNb].Indices; }
+
+private:
+
+	// Whether converted data match the draw list content and transform.
+	bool IsUpToDate(const FImGuiDrawList& DrawList, const FTransform2D& InTransform) const;
+
+	struct FBatch
+	{
+		TArray<FSlateVertex> Vertices;
+		TArray<SlateIndex> Indices;
+	};
+
+	TArray<FBatch> Batches;
+	FTransform2D Transform;
+	uint64 ContentHash = 0;
+	bool bValid = false;
 };
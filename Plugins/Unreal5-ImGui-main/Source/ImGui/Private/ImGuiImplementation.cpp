@@ -41,10 +41,31 @@ struct FImGuiContextHandle : public Utilities::TRedirectingHandle<ImGuiContext*>
 
 static ImGuiContext* ImGuiContextPtr = nullptr;
 static FImGuiContextHandle ImGuiContextPtrHandle(ImGuiContextPtr);
+#else
+static ImGuiContext* ImGuiContextPtr = nullptr;
+#endif // WITH_EDITOR
 
-// Get the global ImGui context pointer (GImGui) indirectly to allow redirections in obsolete modules.
-#define GImGui (ImGuiContextPtrHandle.Get())
+// Get the global ImGui context pointer (GImGui). Contexts are only used on the game thread, but ImGui allocations are
+// also made on worker threads (font atlas builds) and ImGui::MemAlloc reports them to the current context. On other
+// threads the current context is always null, so they never touch the one used by the game thread.
+static ImGuiContext*& GetCurrentContextPtr()
+{
+	if (IsInGameThread())
+	{
+#if WITH_EDITOR
+		// Indirectly to allow redirections in obsolete modules.
+		return ImGuiContextPtrHandle.Get();
+#else
+		return ImGuiContextPtr;
 #endif // WITH_EDITOR
+	}
+
+	static thread_local ImGuiContext* WorkerContextPtr = nullptr;
+	WorkerContextPtr = nullptr;
+	return WorkerContextPtr;
+}
+
+#define GImGui (GetCurrentContextPtr())
 
 #include "imgui.cpp"
 #include "imgui_demo.cpp"
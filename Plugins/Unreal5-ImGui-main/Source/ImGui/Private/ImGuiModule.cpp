@@ -96,6 +96,18 @@ FImGuiTextureHandle FImGuiModule::RegisterTexture(const FName& Name, class UText
 	return FImGuiTextureHandle{ Name, ImGuiInterops::ToImTextureID(Index) };
 }
 
+FImGuiTextureHandle FImGuiModule::RegisterDynamicTexture(const FName& Name, int32 Width, int32 Height, EPixelFormat Format, bool bFilterNearest)
+{
+	const TextureIndex Index = ImGuiModuleManager->GetTextureManager().CreateDynamicTexture(Name, Width, Height, Format, bFilterNearest);
+	return FImGuiTextureHandle{ Name, ImGuiInterops::ToImTextureID(Index) };
+}
+
+bool FImGuiModule::UpdateDynamicTexture(const FImGuiTextureHandle& Handle, const FIntRect& Rect, const uint8* SrcData, uint32 SrcPitch)
+{
+	return Handle.IsValid() && ImGuiModuleManager->GetTextureManager().UpdateDynamicTexture(
+		ImGuiInterops::ToTextureIndex(Handle.GetTextureId()), Rect, SrcData, SrcPitch);
+}
+
 void FImGuiModule::ReleaseTexture(const FImGuiTextureHandle& Handle)
 {
 	if (Handle.IsValid())
@@ -112,6 +124,17 @@ void FImGuiModule::RebuildFontAtlas()
 	}
 }
 
+void FImGuiModule::RequestKeepAlive()
+{
+	if (ImGuiModuleManager)
+	{
+		if (FImGuiContextProxy* ContextProxy = ImGuiModuleManager->GetContextManager().GetCurrentContextProxy())
+		{
+			ContextProxy->RequestKeepAlive();
+		}
+	}
+}
+
 void FImGuiModule::StartupModule()
 {
 	// Initialize handles to allow cross-module redirections. Other handles will always look for parents in the active
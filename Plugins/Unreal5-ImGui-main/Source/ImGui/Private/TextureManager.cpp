@@ -4,10 +4,81 @@
 #include "RHITypes.h"
 #include <Engine/Texture2D.h>
 #include <Framework/Application/SlateApplication.h>
+#include <HAL/IConsoleManager.h>
+
+#include <Misc/ScopeLock.h>
 
 #include <algorithm>
 
 
+namespace
+{
+	// Pixels and region of one dynamic texture update. Both must live until the render thread uploads them.
+	struct FStagingBuffer
+	{
+		TArray<uint8> Data;
+		FUpdateTextureRegion2D Region;
+	};
+
+	// Staging buffers are taken on the game thread and given back on the render thread. Buffers keep their capacity,
+	// so updates of the same size stop allocating after the first few frames.
+	class FStagingBufferPool
+	{
+	public:
+
+		~FStagingBufferPool()
+		{
+			for (FStagingBuffer* Buffer : FreeBuffers)
+			{
+				delete Buffer;
+			}
+		}
+
+		FStagingBuffer* Acquire()
+		{
+			{
+				FScopeLock Lock(&CriticalSection);
+				if (FreeBuffers.Num() > 0)
+				{
+#if (ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 4)
+					return FreeBuffers.Pop(EAllowShrinking::No);
+#else
+					return FreeBuffers.Pop(false);
+#endif
+				}
+			}
+			return new FStagingBuffer();
+		}
+
+		void Release(FStagingBuffer* Buffer)
+		{
+			{
+				FScopeLock Lock(&CriticalSection);
+				if (FreeBuffers.Num() < MaxFreeBuffers)
+				{
+					FreeBuffers.Push(Buffer);
+					return;
+				}
+			}
+			delete Buffer;
+		}
+
+	private:
+
+		// Enough for a few textures updated every frame, with a couple of frames in flight.
+		static constexpr int32 MaxFreeBuffers = 16;
+
+		FCriticalSection CriticalSection;
+		TArray<FStagingBuffer*> FreeBuffers;
+	};
+
+	FStagingBufferPool& GetStagingBufferPool()
+	{
+		static FStagingBufferPool Pool;
+		return Pool;
+	}
+}
+
 void FTextureManager::InitializeErrorTexture(const FColor& Color)
 {
 	CreatePlainTextureInternal(NAME_ErrorTexture, 2, 2, Color);
@@ -36,10 +107,78 @@ TextureIndex FTextureManager::CreateTextureResources(const FName& Name, UTexture
 	return AddTextureEntry(Name, Texture, false);
 }
 
+TextureIndex FTextureManager::CreateDynamicTexture(const FName& Name, int32 Width, int32 Height, EPixelFormat Format, bool bFilterNearest)
+{
+	checkf(Name != NAME_None, TEXT("Trying to create a texture with a name 'NAME_None' is not allowed."));
+	checkf(Width > 0 && Height > 0, TEXT("Invalid dynamic texture size %dx%d."), Width, Height);
+	checkf(GPixelFormats[Format].BlockSizeX == 1 && GPixelFormats[Format].BlockSizeY == 1,
+		TEXT("Dynamic textures need a pixel format with one pixel per block."));
+
+	UTexture2D* Texture = UTexture2D::CreateTransient(Width, Height, Format);
+	if (bFilterNearest)
+	{
+		Texture->Filter = TF_Nearest;
+	}
+	Texture->UpdateResource();
+
+	// Entry roots the texture and releases it together with the resources.
+	const TextureIndex Index = AddTextureEntry(Name, Texture, true);
+	DynamicTextures.Add(Index, { Texture, { Width, Height }, static_cast<uint32>(GPixelFormats[Format].BlockBytes) });
+	return Index;
+}
+
+bool FTextureManager::UpdateDynamicTexture(TextureIndex Index, const FIntRect& Rect, const uint8* SrcData, uint32 SrcPitch)
+{
+	const FDynamicTexture* DynamicTexture = DynamicTextures.Find(Index);
+	UTexture2D* Texture = DynamicTexture ? DynamicTexture->Texture.Get() : nullptr;
+	if (!Texture || !SrcData || Rect.Min.X < 0 || Rect.Min.Y < 0 || Rect.Max.X > DynamicTexture->Size.X
+		|| Rect.Max.Y > DynamicTexture->Size.Y || Rect.Width() <= 0 || Rect.Height() <= 0)
+	{
+		return false;
+	}
+
+	const uint32 RowSize = Rect.Width() * DynamicTexture->BytesPerPixel;
+	const int32 NumRows = Rect.Height();
+
+	FStagingBuffer* Staging = GetStagingBufferPool().Acquire();
+#if (ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 4)
+	Staging->Data.SetNumUninitialized(RowSize * NumRows, EAllowShrinking::No);
+#else
+	Staging->Data.SetNumUninitialized(RowSize * NumRows, false);
+#endif
+
+	if (SrcPitch == RowSize)
+	{
+		FMemory::Memcpy(Staging->Data.GetData(), SrcData, RowSize * NumRows);
+	}
+	else
+	{
+		for (int32 Row = 0; Row < NumRows; Row++)
+		{
+			FMemory::Memcpy(Staging->Data.GetData() + Row * RowSize, SrcData + Row * SrcPitch, RowSize);
+		}
+	}
+
+	// Region lives in the staging buffer, so nothing is allocated for it.
+	Staging->Region = FUpdateTextureRegion2D(Rect.Min.X, Rect.Min.Y, 0, 0, Rect.Width(), NumRows);
+	Texture->UpdateTextureRegions(0, 1u, &Staging->Region, RowSize, DynamicTexture->BytesPerPixel, Staging->Data.GetData(),
+		[Staging](uint8*, const FUpdateTextureRegion2D*) { GetStagingBufferPool().Release(Staging); });
+
+	return true;
+}
+
 void FTextureManager::ReleaseTextureResources(TextureIndex Index)
 {
 	checkf(IsInRange(Index), TEXT("Invalid texture index %d. Texture resources array has %d entries total."), Index, TextureResources.Num());
 
+	// Releasing an entry twice must not put it twice on the free list.
+	if (IsValidTexture(Index))
+	{
+		TextureIndices.Remove(TextureResources[Index].GetName());
+		DynamicTextures.Remove(Index);
+		FreeIndices.Push(Index);
+	}
+
 	TextureResources[Index] = {};
 }
 
@@ -92,22 +231,30 @@ TextureIndex FTextureManager::AddTextureEntry(const FName& Name, UTexture* Textu
 	// Try to find an entry with that name.
 	TextureIndex Index = FindTextureIndex(Name);
 
-	// If this is a new name, try to find an entry to reuse.
-	if (Index == INDEX_NONE)
+	// If this is a new name, try to reuse a released entry.
+	if (Index == INDEX_NONE && FreeIndices.Num() > 0)
 	{
-		Index = FindTextureIndex(NAME_None);
+#if (ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 4)
+		Index = FreeIndices.Pop(EAllowShrinking::No);
+#else
+		Index = FreeIndices.Pop(false);
+#endif
 	}
 
 	// Either update/reuse an entry or add a new one.
 	if (Index != INDEX_NONE)
 	{
+		// Dynamic texture of an updated entry is released with the old resources.
+		DynamicTextures.Remove(Index);
 		TextureResources[Index] = { Name, Texture, bAddToRoot };
-		return Index;
 	}
 	else
 	{
-		return TextureResources.Emplace(Name, Texture, bAddToRoot);
+		Index = TextureResources.Emplace(Name, Texture, bAddToRoot);
 	}
+
+	TextureIndices.Add(Name, Index);
+	return Index;
 }
 
 FTextureManager::FTextureEntry::FTextureEntry(const FName& InName, UTexture* InTexture, bool bAddToRoot)
@@ -186,3 +333,81 @@ void FTextureManager::FTextureEntry::Reset(bool bReleaseResources)
 	Brush = FSlateNoResource();
 	CachedResourceHandle = FSlateResourceHandle();
 }
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	DEFINE_LOG_CATEGORY_STATIC(LogImGuiTextureManager, Log, All);
+
+	// Registers, finds and releases textures in a separate manager and logs timings of each step. All entries share
+	// one texture, so what is measured is bookkeeping and Slate handles rather than texture creation.
+	FAutoConsoleCommand TextureManagerBenchmarkCommand(
+		TEXT("ImGui.Benchmark.TextureManager"),
+		TEXT("Times register, find and release of ImGui textures. Optional argument: number of textures (default 1000)."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if (!FSlateApplication::IsInitialized())
+			{
+				UE_LOG(LogImGuiTextureManager, Warning, TEXT("Texture manager benchmark needs Slate to be initialized."));
+				return;
+			}
+
+			const int32 NumTextures = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+
+			UTexture2D* Texture = UTexture2D::CreateTransient(1, 1);
+			Texture->AddToRoot();
+
+			TArray<FName> Names;
+			Names.Reserve(NumTextures);
+			for (int32 Idx = 0; Idx < NumTextures; Idx++)
+			{
+				Names.Emplace(*FString::Printf(TEXT("ImGuiBenchmarkTexture_%d"), Idx));
+			}
+
+			FTextureManager TextureManager;
+			TArray<TextureIndex> Indices;
+			Indices.SetNumUninitialized(NumTextures);
+
+			double StartTime = FPlatformTime::Seconds();
+			for (int32 Idx = 0; Idx < NumTextures; Idx++)
+			{
+				Indices[Idx] = TextureManager.CreateTextureResources(Names[Idx], Texture);
+			}
+			const double RegisterSeconds = FPlatformTime::Seconds() - StartTime;
+
+			int32 NumMismatches = 0;
+			StartTime = FPlatformTime::Seconds();
+			for (int32 Idx = 0; Idx < NumTextures; Idx++)
+			{
+				NumMismatches += TextureManager.FindTextureIndex(Names[Idx]) != Indices[Idx] ? 1 : 0;
+			}
+			const double FindSeconds = FPlatformTime::Seconds() - StartTime;
+
+			StartTime = FPlatformTime::Seconds();
+			for (int32 Idx = 0; Idx < NumTextures; Idx++)
+			{
+				TextureManager.ReleaseTextureResources(Indices[Idx]);
+			}
+			const double ReleaseSeconds = FPlatformTime::Seconds() - StartTime;
+
+			// Registering again should take every released entry back, without growing.
+			StartTime = FPlatformTime::Seconds();
+			for (int32 Idx = 0; Idx < NumTextures; Idx++)
+			{
+				Indices[Idx] = TextureManager.CreateTextureResources(Names[Idx], Texture);
+			}
+			const double ReuseSeconds = FPlatformTime::Seconds() - StartTime;
+
+			for (int32 Idx = 0; Idx < NumTextures; Idx++)
+			{
+				NumMismatches += Indices[Idx] < NumTextures ? 0 : 1;
+				TextureManager.ReleaseTextureResources(Indices[Idx]);
+			}
+
+			Texture->RemoveFromRoot();
+
+			UE_LOG(LogImGuiTextureManager, Log, TEXT("%d textures: register %.3f ms, find %.3f ms, release %.3f ms, register into released %.3f ms, %d mismatches"),
+				NumTextures, RegisterSeconds * 1000.0, FindSeconds * 1000.0, ReleaseSeconds * 1000.0, ReuseSeconds * 1000.0, NumMismatches);
+		}));
+}
+#endif // !UE_BUILD_SHIPPING
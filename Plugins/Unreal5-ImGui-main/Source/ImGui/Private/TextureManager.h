@@ -2,12 +2,14 @@
 
 #pragma once
 
+#include <PixelFormat.h>
 #include <Styling/SlateBrush.h>
 #include <Textures/SlateShaderResource.h>
 #include <UObject/WeakObjectPtr.h>
 
 
 class UTexture;
+class UTexture2D;
 
 // Index type to be used as a texture handle.
 using TextureIndex = int32;
@@ -41,7 +43,8 @@ public:
 	// @returns The index of a texture with given name or INDEX_NONE if there is no such texture
 	TextureIndex FindTextureIndex(const FName& Name) const
 	{
-		return TextureResources.IndexOfByPredicate([&](const auto& Entry) { return Entry.GetName() == Name; });
+		const TextureIndex* Index = TextureIndices.Find(Name);
+		return Index ? *Index : INDEX_NONE;
 	}
 
 	// Get the name of a texture at given index. Returns NAME_None, if index is out of range.
@@ -86,6 +89,24 @@ public:
 	// @returns The index to created/updated texture resources
 	TextureIndex CreateTextureResources(const FName& Name, UTexture* Texture);
 
+	// Create a texture that can be updated from the CPU with UpdateDynamicTexture.
+	// @param Name - The texture name
+	// @param Width - The texture width
+	// @param Height - The texture height
+	// @param Format - The pixel format, with one pixel per block
+	// @param bFilterNearest - Whether to sample the texture without filtering
+	// @returns The index of a texture that was created
+	TextureIndex CreateDynamicTexture(const FName& Name, int32 Width, int32 Height, EPixelFormat Format, bool bFilterNearest);
+
+	// Copy pixels to a rectangle of a dynamic texture. Pixels are copied to a pooled staging buffer, which is returned
+	// to the pool once the render thread uploaded them, so source data can be reused right after this call.
+	// @param Index - The index of a texture created with CreateDynamicTexture
+	// @param Rect - The destination rectangle, which must be within the texture
+	// @param SrcData - Pixels of the rectangle
+	// @param SrcPitch - The size in bytes of one row of source data
+	// @returns True, if the update was queued and false, if the texture isn't dynamic or the rectangle is out of bounds
+	bool UpdateDynamicTexture(TextureIndex Index, const FIntRect& Rect, const uint8* SrcData, uint32 SrcPitch);
+
 	// Release resources for given texture. Ignores invalid indices.
 	// @param Index - The index of a texture resources
 	void ReleaseTextureResources(TextureIndex Index);
@@ -153,6 +174,22 @@ private:
 	TArray<FTextureEntry> TextureResources;
 	FTextureEntry ErrorTexture;
 
+	// Texture created with CreateDynamicTexture. Its entry owns the texture.
+	struct FDynamicTexture
+	{
+		TWeakObjectPtr<UTexture2D> Texture;
+		FIntPoint Size;
+		uint32 BytesPerPixel;
+	};
+
+	TMap<TextureIndex, FDynamicTexture> DynamicTextures;
+
+	// Index of every valid entry by name.
+	TMap<FName, TextureIndex> TextureIndices;
+
+	// Released entries, reused last-in first-out.
+	TArray<TextureIndex> FreeIndices;
+
 	static constexpr EName NAME_ErrorTexture = NAME_None;
 	static constexpr TextureIndex INDEX_ErrorTexture = INDEX_NONE;
 };
@@ -637,8 +637,13 @@ int32 SImGuiWidget::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeo
 	if (FImGuiContextProxy* ContextProxy = ModuleManager->GetContextManager().GetContextProxy(ContextIndex))
 	{
 		// Manually update ImGui context to minimise lag between creating and rendering ImGui output. This will also
-		// keep frame tearing at minimum because it is executed at the very end of the frame.
-		ContextProxy->Tick(FSlateApplication::Get().GetDeltaTime());
+		// keep frame tearing at minimum because it is executed at the very end of the frame. With decoupled paint,
+		// the frame has already ended after the world tick and we only submit its draw data.
+		const bool bPaintDecoupled = FImGuiContextProxy::IsPaintDecoupled();
+		if (!bPaintDecoupled)
+		{
+			ContextProxy->Tick(FSlateApplication::Get().GetDeltaTime());
+		}
 
 		// Calculate transform from ImGui to screen space. Rounding translation is necessary to keep it pixel-perfect
 		// in older engine versions.
@@ -650,23 +655,28 @@ int32 SImGuiWidget::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeo
 		const FSlateRotatedRect VertexClippingRect{ MyClippingRect };
 #endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
 
-		for (const auto& DrawList : ContextProxy->GetDrawData())
-		{
+		// Decoupled draw data come already converted by the context, with the transform from the last paint.
+		TArray<FImGuiDrawListCache>& Caches = bPaintDecoupled ? ContextProxy->SwapConvertedDrawData(ImGuiToScreen) : DrawListCaches;
+
+		// Only converts what changed since the last paint (or conversion), in parallel when there is enough of it.
+		const TArray<FImGuiDrawList>& DrawLists = ContextProxy->GetDrawData();
 #if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
-			DrawList.CopyVertexData(VertexBuffer, ImGuiToScreen, VertexClippingRect);
+		FImGuiDrawListCache::UpdateAll(Caches, DrawLists, ImGuiToScreen, VertexClippingRect);
 #else
-			DrawList.CopyVertexData(VertexBuffer, ImGuiToScreen);
+		FImGuiDrawListCache::UpdateAll(Caches, DrawLists, ImGuiToScreen);
 #endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
 
-			int IndexBufferOffset = 0;
-			for (int CommandNb = 0; CommandNb < DrawList.NumCommands(); CommandNb++)
-			{
-				const auto& DrawCommand = DrawList.GetCommand(CommandNb, ImGuiToScreen);
-
-				DrawList.CopyIndexData(IndexBuffer, IndexBufferOffset, DrawCommand.NumElements);
+		// Submission stays serial, elements are added to the draw list in order.
+		for (int ListNb = 0; ListNb < DrawLists.Num(); ListNb++)
+		{
+			const FImGuiDrawList& DrawList = DrawLists[ListNb];
+			const FImGuiDrawListCache& DrawListCache = Caches[ListNb];
 
-				// Advance offset by number of copied elements to position it for the next command.
-				IndexBufferOffset += DrawCommand.NumElements;
+			// Each batch of commands sharing texture and clipping is one element with only the vertices it uses, so
+			// submitted data scale with the number of vertices rather than with commands times vertices.
+			for (int BatchNb = 0; BatchNb < DrawList.NumBatches(); BatchNb++)
+			{
+				const auto& DrawCommand = DrawList.GetBatch(BatchNb, ImGuiToScreen);
 
 				// Get texture resource handle for this draw command (null index will be also mapped to a valid texture).
 				const FSlateResourceHandle& Handle = ModuleManager->GetTextureManager().GetTextureHandle(DrawCommand.TextureId);
@@ -683,7 +693,8 @@ int32 SImGuiWidget::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeo
 #endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
 
 				// Add elements to the list.
-				FSlateDrawElement::MakeCustomVerts(OutDrawElements, LayerId, Handle, VertexBuffer, IndexBuffer, nullptr, 0, 0);
+				FSlateDrawElement::MakeCustomVerts(OutDrawElements, LayerId, Handle, DrawListCache.GetVertices(BatchNb),
+					DrawListCache.GetIndices(BatchNb), nullptr, 0, 0);
 
 #if !ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
 				OutDrawElements.PopClip();
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "ImGuiDrawData.h"
 #include "ImGuiModuleDebug.h"
 #include "ImGuiModuleSettings.h"
 
@@ -137,8 +138,8 @@ private:
 	FSlateRenderTransform ImGuiTransform;
 	FSlateRenderTransform ImGuiRenderTransform;
 
-	mutable TArray<FSlateVertex> VertexBuffer;
-	mutable TArray<SlateIndex> IndexBuffer;
+	// Converted draw lists retained between frames, in the same order as the context's draw data.
+	mutable TArray<FImGuiDrawListCache> DrawListCaches;
 
 	int32 ContextIndex = 0;
 
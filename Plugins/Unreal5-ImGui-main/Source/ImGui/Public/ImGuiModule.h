@@ -7,6 +7,7 @@
 #include "ImGuiTextureHandle.h"
 
 #include <Modules/ModuleManager.h>
+#include <PixelFormat.h>
 
 
 class FImGuiModule : public IModuleInterface
@@ -110,6 +111,34 @@ public:
 	 */
 	virtual FImGuiTextureHandle RegisterTexture(const FName& Name, class UTexture* Texture, bool bMakeUnique = false);
 
+	/**
+	 * Create a texture meant to be updated from the CPU, like every frame, and register it. The module owns the texture
+	 * and releases it together with its resources (@see ReleaseTexture). Existing resources with the same name are
+	 * updated/overwritten.
+	 *
+	 * @param Name - Resource name for the texture
+	 * @param Width - Texture width in pixels
+	 * @param Height - Texture height in pixels
+	 * @param Format - Pixel format, only formats with one pixel per block are supported
+	 * @param bFilterNearest - If true, texture is sampled without filtering (useful for grids and other pixel data)
+	 * @returns Handle to the texture resources, which can be used with UpdateDynamicTexture and relevant ImGui functions
+	 */
+	virtual FImGuiTextureHandle RegisterDynamicTexture(const FName& Name, int32 Width, int32 Height,
+		EPixelFormat Format = PF_B8G8R8A8, bool bFilterNearest = false);
+
+	/**
+	 * Update a rectangle of a texture registered with RegisterDynamicTexture. Pixels are copied to a pooled staging
+	 * buffer and uploaded on the render thread, so source data can be reused or released right after this call.
+	 *
+	 * @param Handle - Handle returned by RegisterDynamicTexture
+	 * @param Rect - Rectangle to update in pixels, must be within the texture
+	 * @param SrcData - Pixels of the rectangle, in the texture format
+	 * @param SrcPitch - Size in bytes of one row of source data
+	 * @returns True, if the update was queued and false, if handle doesn't point to a dynamic texture or rectangle is
+	 *     out of bounds
+	 */
+	virtual bool UpdateDynamicTexture(const FImGuiTextureHandle& Handle, const FIntRect& Rect, const uint8* SrcData, uint32 SrcPitch);
+
 	/**
 	 * Unregister texture and release its Slate resources. If handle is null or not valid, this function fails silently
 	 * (for definition of 'valid' look @ FImGuiTextureHandle).
@@ -118,8 +147,22 @@ public:
 	 */
 	virtual void ReleaseTexture(const FImGuiTextureHandle& Handle);
 
+	/**
+	 * Rebuild the font atlas with the current DPI scale and custom fonts (@see FImGuiModuleProperties::AddCustomFont).
+	 * The atlas is built asynchronously: contexts keep using the current fonts until the new atlas is ready and swapped
+	 * in during one of the next module ticks, so new fonts cannot be accessed (e.g. in ImGuiIO::Fonts) right after
+	 * this call.
+	 */
 	virtual void RebuildFontAtlas();
 
+	/**
+	 * Keep the current ImGui context rendering at the full frame rate for the next frame. When idle frames are throttled
+	 * (ImGui.IdleUpdateRate > 0), contexts without input are rendered at a reduced rate. In between, frames are still
+	 * started and drawn to as usual, but discarded and the last rendered output is shown. Controls that change on their
+	 * own, like live plots, should call this every time they are drawn.
+	 */
+	virtual void RequestKeepAlive();
+
 	/**
 	 * Get ImGui module properties.
 	 *
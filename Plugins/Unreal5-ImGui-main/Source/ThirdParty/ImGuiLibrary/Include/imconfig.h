@@ -118,6 +118,10 @@
 // Another way to allow large meshes while keeping 16-bit indices is to handle ImDrawCmd::VtxOffset in your renderer.
 // Read about ImGuiBackendFlags_RendererHasVtxOffset for details.
 //#define ImDrawIdx unsigned int
+// UE: ImGui module enables 32-bit indices where they match Slate indices, so index data can be copied without conversion.
+#if defined(IMGUI_USE_32BIT_INDICES) && IMGUI_USE_32BIT_INDICES
+#define ImDrawIdx unsigned int
+#endif
 
 //---- Override ImDrawCallback signature (will need to modify renderer backends accordingly)
 //struct ImDrawList;
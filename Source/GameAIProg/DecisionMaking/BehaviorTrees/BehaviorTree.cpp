@@ -0,0 +1,295 @@
+#include "BehaviorTree.h"
+#include <algorithm>
+#include "GameAIProg/Movement/SteeringBehaviors/SteeringAgent.h"
+
+//*************
+//BLACKBOARD
+void FBTBlackboard::SetFloat(int32 Key, float Value)
+{
+	check(Key < NumFloats);
+	if (Floats[Key] != Value)
+	{
+		Floats[Key] = Value;
+		ChangedKeys |= FloatKey(Key);
+	}
+}
+
+void FBTBlackboard::SetInt(int32 Key, int32 Value)
+{
+	check(Key < NumInts);
+	if (Ints[Key] != Value)
+	{
+		Ints[Key] = Value;
+		ChangedKeys |= IntKey(Key);
+	}
+}
+
+void FBTBlackboard::SetVector(int32 Key, const FVector2D& Value)
+{
+	check(Key < NumVectors);
+	if (Vectors[Key] != Value)
+	{
+		Vectors[Key] = Value;
+		ChangedKeys |= VectorKey(Key);
+	}
+}
+
+void FBTBlackboard::SetFlag(int32 Key, bool bValue)
+{
+	if (GetFlag(Key) != bValue)
+	{
+		Flags ^= 1u << Key;
+		ChangedKeys |= FlagKey(Key);
+	}
+}
+
+//**********************
+//BEHAVIOR TREE BUILDER
+FBehaviorTree::FNode& FBehaviorTreeBuilder::AddNode(FBehaviorTree::ENodeType Type)
+{
+	checkf(OpenComposites.size() > 0 || Nodes.empty(), TEXT("A behavior tree can only have one root"));
+	checkf(Nodes.size() < MAX_int16, TEXT("Behavior tree has too many nodes"));
+
+	FBehaviorTree::FNode& Node = Nodes.emplace_back();
+	Node.Type = Type;
+	Node.Parent = OpenComposites.empty() ? INDEX_NONE : OpenComposites.back();
+	Node.SubtreeEnd = static_cast<int16>(Nodes.size());
+	return Node;
+}
+
+void FBehaviorTreeBuilder::Begin(FBehaviorTree::ENodeType Type)
+{
+	AddNode(Type);
+	OpenComposites.push_back(static_cast<int16>(Nodes.size() - 1));
+}
+
+void FBehaviorTreeBuilder::End()
+{
+	checkf(!OpenComposites.empty(), TEXT("End() without matching Begin"));
+
+	Nodes[OpenComposites.back()].SubtreeEnd = static_cast<int16>(Nodes.size());
+	OpenComposites.pop_back();
+}
+
+void FBehaviorTreeBuilder::AddCondition(FBTCondition Condition, uint32 ObservedKeys)
+{
+	check(Condition);
+
+	FBehaviorTree::FNode& Node = AddNode(FBehaviorTree::ENodeType::Condition);
+	Node.Condition = Condition;
+	Node.ObservedKeys = ObservedKeys;
+}
+
+void FBehaviorTreeBuilder::AddAction(FBTAction Action)
+{
+	check(Action);
+
+	AddNode(FBehaviorTree::ENodeType::Action).Action = Action;
+}
+
+void FBehaviorTreeBuilder::AddSteeringAction(int32 BehaviorSlot, int32 TargetVectorKey)
+{
+	check(BehaviorSlot >= 0 && BehaviorSlot < FBTBlackboard::NumBehaviors);
+
+	FBehaviorTree::FNode& Node = AddNode(FBehaviorTree::ENodeType::SteeringAction);
+	Node.Param0 = static_cast<int16>(BehaviorSlot);
+	Node.Param1 = static_cast<int16>(TargetVectorKey);
+	if (TargetVectorKey != INDEX_NONE)
+		Node.ObservedKeys = FBTBlackboard::VectorKey(TargetVectorKey);
+}
+
+std::shared_ptr<const FBehaviorTree> FBehaviorTreeBuilder::Build() const
+{
+	checkf(OpenComposites.empty(), TEXT("Behavior tree has unclosed composites"));
+	checkf(!Nodes.empty(), TEXT("Behavior tree has no nodes"));
+
+	auto Tree = std::make_shared<FBehaviorTree>();
+	Tree->Nodes = Nodes;
+	for (const FBehaviorTree::FNode& Node : Nodes)
+	{
+		Tree->ObservedKeys |= Node.ObservedKeys;
+	}
+
+	return Tree;
+}
+
+//*********************
+//BEHAVIOR TREE RUNNER
+FBehaviorTreeRunner::FBehaviorTreeRunner(std::shared_ptr<const FBehaviorTree> InTree)
+	: Tree(std::move(InTree))
+{
+	check(Tree);
+}
+
+void FBehaviorTreeRunner::Reserve(int32 NumAgents)
+{
+	Agents.reserve(NumAgents);
+	Instances.reserve(NumAgents);
+	Statuses.reserve(static_cast<size_t>(NumAgents) * Tree->GetNumNodes());
+}
+
+int32 FBehaviorTreeRunner::AddAgent(ASteeringAgent* Agent)
+{
+	check(Agent);
+
+	Agents.push_back(Agent);
+	Instances.emplace_back();
+	Statuses.resize(Statuses.size() + Tree->GetNumNodes(), EBTStatus::Invalid);
+
+	return static_cast<int32>(Agents.size() - 1);
+}
+
+int32 FBehaviorTreeRunner::FindAgent(const ASteeringAgent* Agent) const
+{
+	const auto It = std::find(Agents.begin(), Agents.end(), Agent);
+	return It != Agents.end() ? static_cast<int32>(It - Agents.begin()) : INDEX_NONE;
+}
+
+void FBehaviorTreeRunner::RemoveAgent(ASteeringAgent* Agent)
+{
+	const int32 Index = FindAgent(Agent);
+	if (Index == INDEX_NONE)
+		return;
+
+	const int32 NumNodes = Tree->GetNumNodes();
+	const int32 Last = static_cast<int32>(Agents.size() - 1);
+
+	Agents[Index] = Agents[Last];
+	Instances[Index] = Instances[Last];
+	std::copy_n(Statuses.begin() + Last * NumNodes, NumNodes, Statuses.begin() + Index * NumNodes);
+
+	Agents.pop_back();
+	Instances.pop_back();
+	Statuses.resize(Statuses.size() - NumNodes);
+}
+
+void FBehaviorTreeRunner::Clear()
+{
+	Agents.clear();
+	Instances.clear();
+	Statuses.clear();
+}
+
+EBTStatus FBehaviorTreeRunner::GetNodeStatus(int32 AgentIndex, int32 NodeIndex) const
+{
+	return Statuses[AgentIndex * Tree->GetNumNodes() + NodeIndex];
+}
+
+void FBehaviorTreeRunner::Tick(float DeltaT)
+{
+	const int32 NumNodes = Tree->GetNumNodes();
+	const uint32 ObservedKeys = Tree->GetObservedKeys();
+	NumNodesExecuted = 0;
+
+	for (size_t i{0}; i < Agents.size(); ++i)
+	{
+		FInstance& Instance = Instances[i];
+		EBTStatus* const AgentStatuses = &Statuses[i * NumNodes];
+
+		// Changes made while executing this tick are picked up next tick
+		const bool bObservedKeyChanged = (Instance.Blackboard.GetChangedKeys() & ObservedKeys) != 0;
+		Instance.Blackboard.ClearChangedKeys();
+
+		FBTContext Context{*Agents[i], Instance.Blackboard, DeltaT};
+
+		if (bObservedKeyChanged || Instance.RunningNode == INDEX_NONE)
+		{
+			// Full evaluation from the root, aborts whatever was running. A finished run starts over, so conditions
+			// that read the agent rather than the blackboard are evaluated again
+			Instance.RunningNode = INDEX_NONE;
+			std::fill_n(AgentStatuses, NumNodes, EBTStatus::Invalid);
+			ExecuteNode(0, Instance, Context, AgentStatuses);
+		}
+		else
+		{
+			const int32 Running = Instance.RunningNode;
+			Instance.RunningNode = INDEX_NONE;
+
+			const EBTStatus Status = ExecuteNode(Running, Instance, Context, AgentStatuses);
+			if (Status != EBTStatus::Running)
+				ResumeFrom(Running, Status, Instance, Context, AgentStatuses);
+		}
+	}
+}
+
+EBTStatus FBehaviorTreeRunner::ExecuteNode(int32 NodeIndex, FInstance& Instance, FBTContext& Context, EBTStatus* AgentStatuses)
+{
+	++NumNodesExecuted;
+
+	const FBehaviorTree::FNode& Node = Tree->GetNode(NodeIndex);
+	EBTStatus Status = EBTStatus::Failure;
+
+	switch (Node.Type)
+	{
+	case FBehaviorTree::ENodeType::Selector:
+	case FBehaviorTree::ENodeType::Sequence:
+		Status = ExecuteChildrenFrom(NodeIndex, NodeIndex + 1, Instance, Context, AgentStatuses);
+		break;
+	case FBehaviorTree::ENodeType::Condition:
+		Status = Node.Condition(Context.Agent, Context.Blackboard) ? EBTStatus::Success : EBTStatus::Failure;
+		break;
+	case FBehaviorTree::ENodeType::Action:
+		Status = Node.Action(Context);
+		break;
+	case FBehaviorTree::ENodeType::SteeringAction:
+		if (ISteeringBehavior* const Behavior = Context.Blackboard.GetBehavior(Node.Param0))
+		{
+			if (Node.Param1 != INDEX_NONE)
+			{
+				FTargetData Target;
+				Target.Position = Context.Blackboard.GetVector(Node.Param1);
+				Behavior->SetTarget(Target);
+			}
+
+			Context.Agent.SetSteeringBehavior(Behavior);
+			Status = EBTStatus::Running;
+		}
+		break;
+	default:
+		assert(false); // Unknown node type
+	}
+
+	const bool bIsLeaf = Node.SubtreeEnd == NodeIndex + 1;
+	if (bIsLeaf && Status == EBTStatus::Running)
+		Instance.RunningNode = static_cast<int16>(NodeIndex);
+
+	AgentStatuses[NodeIndex] = Status;
+	return Status;
+}
+
+EBTStatus FBehaviorTreeRunner::ExecuteChildrenFrom(int32 Parent, int32 FirstChild, FInstance& Instance, FBTContext& Context, EBTStatus* AgentStatuses)
+{
+	const FBehaviorTree::FNode& Composite = Tree->GetNode(Parent);
+
+	// A sequence goes on while its children succeed, a selector while they fail
+	const EBTStatus Continue = Composite.Type == FBehaviorTree::ENodeType::Sequence ? EBTStatus::Success : EBTStatus::Failure;
+
+	for (int32 Child = FirstChild; Child < Composite.SubtreeEnd; Child = Tree->GetNode(Child).SubtreeEnd)
+	{
+		const EBTStatus Status = ExecuteNode(Child, Instance, Context, AgentStatuses);
+		if (Status != Continue)
+			return Status;
+	}
+
+	return Continue;
+}
+
+EBTStatus FBehaviorTreeRunner::ResumeFrom(int32 NodeIndex, EBTStatus NodeStatus, FInstance& Instance, FBTContext& Context, EBTStatus* AgentStatuses)
+{
+	// Climb up from a finished leaf, letting every composite continue with the siblings after it
+	EBTStatus Status = NodeStatus;
+	for (int32 Child = NodeIndex; Tree->GetNode(Child).Parent != INDEX_NONE; Child = Tree->GetNode(Child).Parent)
+	{
+		const int32 Parent = Tree->GetNode(Child).Parent;
+		const EBTStatus Continue = Tree->GetNode(Parent).Type == FBehaviorTree::ENodeType::Sequence ? EBTStatus::Success : EBTStatus::Failure;
+
+		if (Status == Continue)
+			Status = ExecuteChildrenFrom(Parent, Tree->GetNode(Child).SubtreeEnd, Instance, Context, AgentStatuses);
+
+		AgentStatuses[Parent] = Status;
+		if (Status == EBTStatus::Running)
+			break;
+	}
+
+	return Status;
+}
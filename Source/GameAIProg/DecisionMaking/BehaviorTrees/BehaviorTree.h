@@ -0,0 +1,198 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <memory>
+#include <vector>
+
+class ASteeringAgent;
+class ISteeringBehavior;
+
+/*
+ * Behavior tree with a shared, immutable node array and compact per-agent state.
+ *
+ * Nodes are stored in pre-order, every node knows its parent and where its subtree ends, so the children of a composite
+ * are found by hopping from SubtreeEnd to SubtreeEnd. Per agent the runner only keeps one status byte per node, the
+ * running leaf and a fixed size blackboard.
+ *
+ * Ticking is event driven: an agent with a running leaf only resumes from that leaf (and climbs back up through its
+ * parents when it finishes). The tree is only traversed from the root again when a blackboard key that some node
+ * observes has changed, or on the tick after the previous run has finished.
+ */
+
+enum class EBTStatus : uint8
+{
+	Invalid,
+	Success,
+	Failure,
+	Running
+};
+
+// Fixed size, typed blackboard that records which keys changed since the last tick
+struct FBTBlackboard final
+{
+	static constexpr int32 NumFloats{8};
+	static constexpr int32 NumInts{4};
+	static constexpr int32 NumVectors{4};
+	static constexpr int32 NumFlags{8};
+	static constexpr int32 NumBehaviors{4};
+
+	// Bits used in ChangedKeys and in the observed keys of a node
+	static constexpr uint32 FloatKey(int32 Key) { return 1u << Key; }
+	static constexpr uint32 IntKey(int32 Key) { return 1u << (NumFloats + Key); }
+	static constexpr uint32 VectorKey(int32 Key) { return 1u << (NumFloats + NumInts + Key); }
+	static constexpr uint32 FlagKey(int32 Key) { return 1u << (NumFloats + NumInts + NumVectors + Key); }
+
+	float GetFloat(int32 Key) const { check(Key < NumFloats); return Floats[Key]; }
+	void SetFloat(int32 Key, float Value);
+
+	int32 GetInt(int32 Key) const { check(Key < NumInts); return Ints[Key]; }
+	void SetInt(int32 Key, int32 Value);
+
+	const FVector2D& GetVector(int32 Key) const { check(Key < NumVectors); return Vectors[Key]; }
+	void SetVector(int32 Key, const FVector2D& Value);
+
+	bool GetFlag(int32 Key) const { check(Key < NumFlags); return (Flags & (1u << Key)) != 0; }
+	void SetFlag(int32 Key, bool bValue);
+
+	// Steering behaviors the tree can switch between, owned by whoever registers the agent (not observable)
+	ISteeringBehavior* GetBehavior(int32 Slot) const { check(Slot < NumBehaviors); return Behaviors[Slot]; }
+	void SetBehavior(int32 Slot, ISteeringBehavior* Behavior) { check(Slot < NumBehaviors); Behaviors[Slot] = Behavior; }
+
+	uint32 GetChangedKeys() const { return ChangedKeys; }
+	void ClearChangedKeys() { ChangedKeys = 0; }
+
+	FBTBlackboard()
+	{
+		for (FVector2D& Vector : Vectors)
+			Vector = FVector2D::ZeroVector;
+	}
+
+private:
+	float Floats[NumFloats]{};
+	int32 Ints[NumInts]{};
+	FVector2D Vectors[NumVectors];
+	uint32 Flags{0};
+	ISteeringBehavior* Behaviors[NumBehaviors]{};
+	uint32 ChangedKeys{0};
+};
+
+struct FBTContext final
+{
+	ASteeringAgent& Agent;
+	FBTBlackboard& Blackboard;
+	float DeltaT;
+};
+
+using FBTCondition = bool (*)(const ASteeringAgent& Agent, const FBTBlackboard& Blackboard);
+using FBTAction = EBTStatus (*)(FBTContext& Context);
+
+class FBehaviorTree final
+{
+public:
+	enum class ENodeType : uint8
+	{
+		Selector,
+		Sequence,
+		Condition,
+		Action,
+		SteeringAction // sets behavior slot Param0 on the agent, targeting vector key Param1 (if any), keeps running
+	};
+
+	struct FNode
+	{
+		ENodeType Type{ENodeType::Action};
+		int16 Parent{INDEX_NONE};
+		int16 SubtreeEnd{0};
+		int16 Param0{INDEX_NONE};
+		int16 Param1{INDEX_NONE};
+		uint32 ObservedKeys{0};
+		FBTCondition Condition{nullptr};
+		FBTAction Action{nullptr};
+	};
+
+	int32 GetNumNodes() const { return static_cast<int32>(Nodes.size()); }
+	const FNode& GetNode(int32 Index) const { return Nodes[Index]; }
+	uint32 GetObservedKeys() const { return ObservedKeys; }
+
+private:
+	friend class FBehaviorTreeBuilder;
+
+	std::vector<FNode> Nodes{};
+	uint32 ObservedKeys{0}; // union of all nodes
+};
+
+/*
+ * Builds a tree depth first, every Begin... needs a matching End.
+ *
+ *	Builder.BeginSelector();
+ *		Builder.BeginSequence();
+ *			Builder.AddCondition(&IsThreatened, FBTBlackboard::FlagKey(Threatened));
+ *			Builder.AddSteeringAction(FleeSlot, ThreatKey);
+ *		Builder.End();
+ *		Builder.AddSteeringAction(WanderSlot);
+ *	Builder.End();
+ */
+class FBehaviorTreeBuilder final
+{
+public:
+	void BeginSelector() { Begin(FBehaviorTree::ENodeType::Selector); }
+	void BeginSequence() { Begin(FBehaviorTree::ENodeType::Sequence); }
+	void End();
+
+	// ObservedKeys: blackboard keys the condition reads, changing one of them re-evaluates the tree
+	void AddCondition(FBTCondition Condition, uint32 ObservedKeys);
+	void AddAction(FBTAction Action);
+	void AddSteeringAction(int32 BehaviorSlot, int32 TargetVectorKey = INDEX_NONE);
+
+	std::shared_ptr<const FBehaviorTree> Build() const;
+
+private:
+	std::vector<FBehaviorTree::FNode> Nodes{};
+	std::vector<int16> OpenComposites{};
+
+	void Begin(FBehaviorTree::ENodeType Type);
+	FBehaviorTree::FNode& AddNode(FBehaviorTree::ENodeType Type);
+};
+
+/*
+ * Runs one tree for many agents, statuses of all agents are stored in one flat array.
+ */
+class FBehaviorTreeRunner final
+{
+public:
+	explicit FBehaviorTreeRunner(std::shared_ptr<const FBehaviorTree> InTree);
+
+	void Reserve(int32 NumAgents);
+	int32 AddAgent(ASteeringAgent* Agent);
+	void RemoveAgent(ASteeringAgent* Agent); // swaps the last agent into the removed slot
+	void Clear();
+
+	void Tick(float DeltaT);
+
+	int32 GetNumAgents() const { return static_cast<int32>(Agents.size()); }
+	int32 FindAgent(const ASteeringAgent* Agent) const;
+	FBTBlackboard& GetBlackboard(int32 Index) { return Instances[Index].Blackboard; }
+	EBTStatus GetNodeStatus(int32 AgentIndex, int32 NodeIndex) const;
+	int32 GetRunningNode(int32 AgentIndex) const { return Instances[AgentIndex].RunningNode; }
+
+	// Number of nodes executed during the last Tick, across all agents
+	int32 GetNumNodesExecuted() const { return NumNodesExecuted; }
+
+private:
+	struct FInstance
+	{
+		FBTBlackboard Blackboard{};
+		int16 RunningNode{INDEX_NONE}; // INDEX_NONE once a run has finished
+	};
+
+	std::shared_ptr<const FBehaviorTree> Tree{};
+
+	std::vector<ASteeringAgent*> Agents{}; // non-owning
+	std::vector<FInstance> Instances{};
+	std::vector<EBTStatus> Statuses{}; // NumAgents x NumNodes
+	int32 NumNodesExecuted{0};
+
+	EBTStatus ExecuteNode(int32 NodeIndex, FInstance& Instance, FBTContext& Context, EBTStatus* AgentStatuses);
+	EBTStatus ExecuteChildrenFrom(int32 Parent, int32 FirstChild, FInstance& Instance, FBTContext& Context, EBTStatus* AgentStatuses);
+	EBTStatus ResumeFrom(int32 NodeIndex, EBTStatus NodeStatus, FInstance& Instance, FBTContext& Context, EBTStatus* AgentStatuses);
+};
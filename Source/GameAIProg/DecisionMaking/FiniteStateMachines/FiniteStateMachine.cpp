@@ -0,0 +1,169 @@
+#include "FiniteStateMachine.h"
+#include <algorithm>
+#include "GameAIProg/Shared/BaseAgent.h"
+
+//***************
+//FSM DEFINITION
+uint8 FFSMDefinition::EvaluateTransitions(uint8 From, const ABaseAgent& Agent, const FFSMInstance& Instance) const
+{
+	const FState& State = States[From];
+	const FTransition* const First = Transitions.data() + State.FirstTransition;
+
+	for (const FTransition* Transition = First; Transition != First + State.NumTransitions; ++Transition)
+	{
+		if (Transition->Condition(Agent, Instance))
+			return Transition->ToState;
+	}
+
+	return InvalidState;
+}
+
+//***********************
+//FSM DEFINITION BUILDER
+uint8 FFSMDefinitionBuilder::AddState(const FName& Name, FFSMAction OnUpdate, FFSMAction OnEnter, FFSMAction OnExit)
+{
+	checkf(States.size() < FFSMDefinition::MaxStates, TEXT("FSM has too many states"));
+
+	FFSMDefinition::FState State{};
+	State.Name = Name;
+	State.OnEnter = OnEnter;
+	State.OnUpdate = OnUpdate;
+	State.OnExit = OnExit;
+	States.push_back(State);
+
+	return static_cast<uint8>(States.size() - 1);
+}
+
+void FFSMDefinitionBuilder::AddTransition(uint8 From, uint8 To, FFSMCondition Condition)
+{
+	checkf(From < States.size() && To < States.size(), TEXT("Transition between unknown states"));
+	checkf(Condition, TEXT("Transition without condition"));
+
+	Transitions.push_back({From, To, Condition});
+}
+
+std::shared_ptr<const FFSMDefinition> FFSMDefinitionBuilder::Build() const
+{
+	auto Definition = std::make_shared<FFSMDefinition>();
+	Definition->States = States;
+	Definition->InitialState = InitialState;
+
+	// Group the transitions per source state, stable so the priority order of AddTransition is kept
+	std::vector<FPendingTransition> Sorted = Transitions;
+	std::stable_sort(Sorted.begin(), Sorted.end(), [](const FPendingTransition& A, const FPendingTransition& B) { return A.From < B.From; });
+
+	Definition->Transitions.reserve(Sorted.size());
+	for (const FPendingTransition& Pending : Sorted)
+	{
+		FFSMDefinition::FState& State = Definition->States[Pending.From];
+		if (State.NumTransitions == 0)
+			State.FirstTransition = static_cast<uint16>(Definition->Transitions.size());
+		++State.NumTransitions;
+
+		Definition->Transitions.push_back({Pending.Condition, Pending.To});
+	}
+
+	return Definition;
+}
+
+//***********
+//FSM RUNNER
+FFSMRunner::FFSMRunner(std::shared_ptr<const FFSMDefinition> InDefinition)
+	: Definition(std::move(InDefinition))
+{
+	check(Definition && Definition->GetNumStates() > 0);
+}
+
+void FFSMRunner::Reserve(int32 NumAgents)
+{
+	Agents.reserve(NumAgents);
+	Instances.reserve(NumAgents);
+	PendingStates.reserve(NumAgents);
+}
+
+int32 FFSMRunner::AddAgent(ABaseAgent* Agent)
+{
+	check(Agent);
+
+	FFSMInstance Instance{};
+	Instance.CurrentState = Definition->GetInitialState();
+
+	Agents.push_back(Agent);
+	Instances.push_back(Instance);
+	PendingStates.push_back(FFSMDefinition::InvalidState);
+
+	const FFSMDefinition::FState& State = Definition->GetState(Instance.CurrentState);
+	if (State.OnEnter)
+		State.OnEnter(*Agent, Instances.back(), 0.f);
+
+	return static_cast<int32>(Agents.size() - 1);
+}
+
+int32 FFSMRunner::FindAgent(const ABaseAgent* Agent) const
+{
+	const auto It = std::find(Agents.begin(), Agents.end(), Agent);
+	return It != Agents.end() ? static_cast<int32>(It - Agents.begin()) : INDEX_NONE;
+}
+
+void FFSMRunner::RemoveAgent(ABaseAgent* Agent)
+{
+	const int32 Index = FindAgent(Agent);
+	if (Index == INDEX_NONE)
+		return;
+
+	const FFSMDefinition::FState& State = Definition->GetState(Instances[Index].CurrentState);
+	if (State.OnExit)
+		State.OnExit(*Agent, Instances[Index], 0.f);
+
+	Agents[Index] = Agents.back();
+	Instances[Index] = Instances.back();
+	Agents.pop_back();
+	Instances.pop_back();
+	PendingStates.pop_back();
+}
+
+void FFSMRunner::Clear()
+{
+	Agents.clear();
+	Instances.clear();
+	PendingStates.clear();
+}
+
+void FFSMRunner::Update(float DeltaT)
+{
+	const FFSMDefinition& Def = *Definition;
+	const size_t NumAgents = Agents.size();
+
+	// Pass 1: transitions only, read-only on agents and instances
+	for (size_t i{0}; i < NumAgents; ++i)
+	{
+		PendingStates[i] = Def.EvaluateTransitions(Instances[i].CurrentState, *Agents[i], Instances[i]);
+	}
+
+	// Pass 2: apply transitions and update
+	for (size_t i{0}; i < NumAgents; ++i)
+	{
+		ABaseAgent& Agent = *Agents[i];
+		FFSMInstance& Instance = Instances[i];
+
+		if (PendingStates[i] != FFSMDefinition::InvalidState && PendingStates[i] != Instance.CurrentState)
+		{
+			const FFSMDefinition::FState& From = Def.GetState(Instance.CurrentState);
+			if (From.OnExit)
+				From.OnExit(Agent, Instance, DeltaT);
+
+			Instance.CurrentState = PendingStates[i];
+			Instance.TimeInState = 0.f;
+
+			const FFSMDefinition::FState& To = Def.GetState(Instance.CurrentState);
+			if (To.OnEnter)
+				To.OnEnter(Agent, Instance, DeltaT);
+		}
+
+		const FFSMDefinition::FState& State = Def.GetState(Instance.CurrentState);
+		if (State.OnUpdate)
+			State.OnUpdate(Agent, Instance, DeltaT);
+
+		Instance.TimeInState += DeltaT;
+	}
+}
@@ -0,0 +1,158 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include <memory>
+#include <vector>
+
+class ABaseAgent;
+
+/*
+ * Data-driven finite state machine.
+ *
+ * ┌──────────────────┐  shared, immutable   ┌──────────────────────┐
+ * │  FFSMDefinition  │◄─────────────────────┤       FFSMRunner     │
+ * │  states[]        │                      │  agents[]            │
+ * │  transitions[]   │                      │  instances[]  (POD)  │
+ * └──────────────────┘                      └──────────────────────┘
+ *
+ * States and transitions live in two flat arrays, the transitions of one state are contiguous. Conditions and actions are
+ * plain function pointers, so a definition never owns per-agent data. Every agent only has an FFSMInstance (state index,
+ * time in state and a fixed size blackboard), which makes adding thousands of agents to a runner allocation free.
+ */
+
+// Fixed size, typed blackboard. Keys are plain slot indices, pick an enum per FSM to name them.
+struct FFSMBlackboard final
+{
+	static constexpr int32 NumFloats{8};
+	static constexpr int32 NumInts{4};
+	static constexpr int32 NumVectors{4};
+
+	float Floats[NumFloats]{};
+	int32 Ints[NumInts]{};
+	FVector2D Vectors[NumVectors];
+	uint32 Flags{0};
+
+	FFSMBlackboard()
+	{
+		for (FVector2D& Vector : Vectors)
+			Vector = FVector2D::ZeroVector;
+	}
+
+	float GetFloat(int32 Key) const { check(Key < NumFloats); return Floats[Key]; }
+	void SetFloat(int32 Key, float Value) { check(Key < NumFloats); Floats[Key] = Value; }
+
+	int32 GetInt(int32 Key) const { check(Key < NumInts); return Ints[Key]; }
+	void SetInt(int32 Key, int32 Value) { check(Key < NumInts); Ints[Key] = Value; }
+
+	const FVector2D& GetVector(int32 Key) const { check(Key < NumVectors); return Vectors[Key]; }
+	void SetVector(int32 Key, const FVector2D& Value) { check(Key < NumVectors); Vectors[Key] = Value; }
+
+	bool GetFlag(int32 Key) const { check(Key < 32); return (Flags & (1u << Key)) != 0; }
+	void SetFlag(int32 Key, bool bValue) { check(Key < 32); Flags = bValue ? (Flags | (1u << Key)) : (Flags & ~(1u << Key)); }
+};
+
+struct FFSMInstance final
+{
+	uint8 CurrentState{0};
+	float TimeInState{0.f};
+	FFSMBlackboard Blackboard{};
+};
+
+using FFSMCondition = bool (*)(const ABaseAgent& Agent, const FFSMInstance& Instance);
+using FFSMAction = void (*)(ABaseAgent& Agent, FFSMInstance& Instance, float DeltaT);
+
+class FFSMDefinition final
+{
+public:
+	static constexpr int32 MaxStates{255};
+	static constexpr uint8 InvalidState{255};
+
+	struct FState
+	{
+		FName Name{};
+		FFSMAction OnEnter{nullptr};
+		FFSMAction OnUpdate{nullptr};
+		FFSMAction OnExit{nullptr};
+		uint16 FirstTransition{0};
+		uint16 NumTransitions{0};
+	};
+
+	struct FTransition
+	{
+		FFSMCondition Condition{nullptr};
+		uint8 ToState{InvalidState};
+	};
+
+	int32 GetNumStates() const { return static_cast<int32>(States.size()); }
+	const FState& GetState(uint8 Index) const { return States[Index]; }
+	uint8 GetInitialState() const { return InitialState; }
+
+	// First transition of From whose condition holds, InvalidState if none does. Transitions are checked in the order they were added.
+	uint8 EvaluateTransitions(uint8 From, const ABaseAgent& Agent, const FFSMInstance& Instance) const;
+
+private:
+	friend class FFSMDefinitionBuilder;
+
+	std::vector<FState> States{};
+	std::vector<FTransition> Transitions{};
+	uint8 InitialState{0};
+};
+
+/*
+ * Builds an FFSMDefinition. Once built, a definition is immutable and meant to be shared by every runner using it.
+ */
+class FFSMDefinitionBuilder final
+{
+public:
+	uint8 AddState(const FName& Name, FFSMAction OnUpdate = nullptr, FFSMAction OnEnter = nullptr, FFSMAction OnExit = nullptr);
+	void AddTransition(uint8 From, uint8 To, FFSMCondition Condition);
+	void SetInitialState(uint8 State) { InitialState = State; }
+
+	std::shared_ptr<const FFSMDefinition> Build() const;
+
+private:
+	struct FPendingTransition
+	{
+		uint8 From;
+		uint8 To;
+		FFSMCondition Condition;
+	};
+
+	std::vector<FFSMDefinition::FState> States{};
+	std::vector<FPendingTransition> Transitions{};
+	uint8 InitialState{0};
+};
+
+/*
+ * Runs one definition for many agents.
+ *
+ * Update first evaluates the transitions of every agent in one tight pass over the instance array (conditions are
+ * read-only), then applies the transitions and runs the state updates in a second pass.
+ */
+class FFSMRunner final
+{
+public:
+	explicit FFSMRunner(std::shared_ptr<const FFSMDefinition> InDefinition);
+
+	void Reserve(int32 NumAgents);
+	int32 AddAgent(ABaseAgent* Agent);
+	void RemoveAgent(ABaseAgent* Agent); // swaps the last agent into the removed slot
+	void Clear();
+
+	void Update(float DeltaT);
+
+	int32 GetNumAgents() const { return static_cast<int32>(Agents.size()); }
+	ABaseAgent* GetAgent(int32 Index) const { return Agents[Index]; }
+	FFSMInstance& GetInstance(int32 Index) { return Instances[Index]; }
+	const FFSMInstance& GetInstance(int32 Index) const { return Instances[Index]; }
+	int32 FindAgent(const ABaseAgent* Agent) const;
+
+	const FFSMDefinition& GetDefinition() const { return *Definition; }
+
+private:
+	std::shared_ptr<const FFSMDefinition> Definition{};
+
+	std::vector<ABaseAgent*> Agents{}; // non-owning
+	std::vector<FFSMInstance> Instances{};
+	std::vector<uint8> PendingStates{};
+};
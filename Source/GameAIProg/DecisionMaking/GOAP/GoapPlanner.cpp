@@ -0,0 +1,353 @@
+#include "GoapPlanner.h"
+#include "GameAIProg/Movement/SteeringBehaviors/SteeringAgent.h"
+#include <algorithm>
+
+//*************
+//GOAP PLANNER
+FGoapPlanner::FGoapPlanner(std::shared_ptr<const FGoapDefinition> InDefinition, int32 InMaxNodes, int32 InMaxCachedPlans)
+	: Definition(std::move(InDefinition))
+	, MaxNodes(InMaxNodes)
+	, MaxCachedPlans(FMath::Max(InMaxCachedPlans, 1))
+{
+	check(Definition && Definition->Actions.size() <= FGoapDefinition::MaxActions);
+	for (const FGoapAction& Action : Definition->Actions)
+	{
+		check(Action.BehaviorSlot >= INDEX_NONE && Action.BehaviorSlot < FGoapAgent::MaxBehaviorSlots);
+	}
+
+	// Keeps the heuristic admissible: every missing fact costs at least the cheapest action, one action fixes at most
+	// MaxEffectBits facts at once
+	if (!Definition->Actions.empty())
+	{
+		MinActionCost = TNumericLimits<float>::Max();
+		for (const FGoapAction& Action : Definition->Actions)
+		{
+			MinActionCost = FMath::Min(MinActionCost, FMath::Max(Action.Cost, 0.f));
+			MaxEffectBits = FMath::Max(MaxEffectBits, FMath::CountBits(Action.Effects.Mask));
+		}
+	}
+
+	Nodes.reserve(MaxNodes);
+	Open.reserve(MaxNodes);
+	BestNodes.Reserve(MaxNodes);
+	Cache.Reserve(MaxCachedPlans);
+	CacheOrder.Reserve(MaxCachedPlans);
+}
+
+void FGoapPlanner::RequestPlan(const FGoapPlanKey& Key)
+{
+	const FGoapPlan* const Cached = Cache.Find(Key);
+	if ((Cached && !Cached->bExhausted) || IsPlanPending(Key))
+		return;
+
+	PendingRequests.Add(Key);
+}
+
+bool FGoapPlanner::IsPlanPending(const FGoapPlanKey& Key) const
+{
+	if (bSearching && ActiveKey == Key)
+		return true;
+
+	for (int32 i{PendingHead}; i < PendingRequests.Num(); ++i)
+	{
+		if (PendingRequests[i] == Key)
+			return true;
+	}
+	return false;
+}
+
+void FGoapPlanner::Update(int32 IterationBudget)
+{
+	while (IterationBudget-- > 0)
+	{
+		if (!bSearching)
+		{
+			if (PendingHead == PendingRequests.Num())
+				return;
+
+			StartSearch(PendingRequests[PendingHead++]);
+
+			// Dropping the consumed part only once it is as large as the rest keeps dequeuing amortized O(1)
+			if (PendingHead == PendingRequests.Num())
+			{
+				PendingRequests.Reset();
+				PendingHead = 0;
+			}
+			else if (PendingHead * 2 >= PendingRequests.Num())
+			{
+				PendingRequests.RemoveAt(0, PendingHead);
+				PendingHead = 0;
+			}
+		}
+
+		Expand();
+	}
+}
+
+void FGoapPlanner::StartSearch(const FGoapPlanKey& Key)
+{
+	ActiveKey = Key;
+	bSearching = true;
+
+	Nodes.clear();
+	Open.clear();
+	BestNodes.Reset();
+
+	Nodes.push_back(FNode{Key.Start, 0.f, Heuristic(Key.Start), INDEX_NONE, 0});
+	Open.push_back(0);
+	BestNodes.Add(Key.Start, 0);
+}
+
+bool FGoapPlanner::Expand()
+{
+	const auto IsWorse = [this](int32 A, int32 B) { return Nodes[A].F > Nodes[B].F; };
+
+	if (Open.empty())
+	{
+		FinishSearch(INDEX_NONE);
+		return true;
+	}
+
+	std::pop_heap(Open.begin(), Open.end(), IsWorse);
+	const int32 Current = Open.back();
+	Open.pop_back();
+
+	const FNode Node = Nodes[Current];
+
+	// A cheaper way to this state was found after the node was queued
+	if (BestNodes.FindChecked(Node.State) != Current)
+		return false;
+
+	if (ActiveKey.Goal.IsMetBy(Node.State))
+	{
+		FinishSearch(Current);
+		return true;
+	}
+
+	for (int32 ActionIndex{0}; ActionIndex < static_cast<int32>(Definition->Actions.size()); ++ActionIndex)
+	{
+		const FGoapAction& Action = Definition->Actions[ActionIndex];
+		if (!Action.Preconditions.IsMetBy(Node.State))
+			continue;
+
+		const FGoapWorldState NextState = Action.Apply(Node.State);
+		if (NextState == Node.State)
+			continue;
+
+		const float G = Node.G + Action.Cost;
+		int32* const BestNode = BestNodes.Find(NextState);
+		if (BestNode && Nodes[*BestNode].G <= G)
+			continue;
+
+		// Out of pool, give up rather than growing without bound. The goal may still be reachable, so the failure is
+		// only handed to the agents waiting for it, later requests search again
+		if (static_cast<int32>(Nodes.size()) >= MaxNodes)
+		{
+			FinishSearch(INDEX_NONE, true);
+			return true;
+		}
+
+		const int32 NewNode = static_cast<int32>(Nodes.size());
+		Nodes.push_back(FNode{NextState, G, G + Heuristic(NextState), Current, static_cast<uint8>(ActionIndex)});
+		BestNodes.Add(NextState, NewNode);
+		Open.push_back(NewNode);
+		std::push_heap(Open.begin(), Open.end(), IsWorse);
+	}
+
+	return false;
+}
+
+void FGoapPlanner::FinishSearch(int32 GoalNode, bool bExhausted)
+{
+	bSearching = false;
+
+	FGoapPlan Plan{};
+	Plan.bExhausted = bExhausted;
+	if (GoalNode != INDEX_NONE)
+	{
+		Plan.bFound = true;
+		Plan.Cost = Nodes[GoalNode].G;
+		for (int32 Node = GoalNode; Nodes[Node].Parent != INDEX_NONE; Node = Nodes[Node].Parent)
+		{
+			Plan.Actions.push_back(Nodes[Node].Action);
+		}
+		std::reverse(Plan.Actions.begin(), Plan.Actions.end());
+	}
+
+	// Retried searches replace their exhausted plan and keep its place in the eviction order
+	if (FGoapPlan* const Existing = Cache.Find(ActiveKey))
+	{
+		*Existing = MoveTemp(Plan);
+		return;
+	}
+
+	if (CacheOrder.Num() < MaxCachedPlans)
+	{
+		CacheOrder.Add(ActiveKey);
+	}
+	else
+	{
+		Cache.Remove(CacheOrder[OldestCached]);
+		CacheOrder[OldestCached] = ActiveKey;
+		OldestCached = (OldestCached + 1) % MaxCachedPlans;
+	}
+
+	Cache.Add(ActiveKey, MoveTemp(Plan));
+}
+
+float FGoapPlanner::Heuristic(FGoapWorldState State) const
+{
+	return FMath::DivideAndRoundUp(ActiveKey.Goal.CountUnmet(State), MaxEffectBits) * MinActionCost;
+}
+
+//************
+//GOAP RUNNER
+FGoapRunner::FGoapRunner(std::shared_ptr<const FGoapDefinition> InDefinition)
+	: Definition(InDefinition)
+	, Planner(InDefinition)
+{
+}
+
+int32 FGoapRunner::AddAgent(ASteeringAgent* Agent, FGoapWorldState WorldState, const FGoapCondition& Goal)
+{
+	FGoapAgent& Entry = Agents.emplace_back();
+	Entry.Agent = Agent;
+	Entry.WorldState = WorldState;
+	Entry.Goal = Goal;
+	return static_cast<int32>(Agents.size()) - 1;
+}
+
+void FGoapRunner::RemoveAgent(ASteeringAgent* Agent)
+{
+	const int32 Index = FindAgent(Agent);
+	if (Index == INDEX_NONE)
+		return;
+
+	Agents[Index] = std::move(Agents.back());
+	Agents.pop_back();
+}
+
+int32 FGoapRunner::FindAgent(const ASteeringAgent* Agent) const
+{
+	for (int32 i{0}; i < static_cast<int32>(Agents.size()); ++i)
+	{
+		if (Agents[i].Agent == Agent)
+			return i;
+	}
+	return INDEX_NONE;
+}
+
+void FGoapRunner::SetWorldState(int32 Index, FGoapWorldState WorldState)
+{
+	FGoapAgent& Entry = Agents[Index];
+	if (Entry.WorldState == WorldState)
+		return;
+
+	Entry.WorldState = WorldState;
+
+	// Executing agents validate their current step themselves, finished ones get another try
+	if (Entry.Status == FGoapAgent::EStatus::Done || Entry.Status == FGoapAgent::EStatus::Failed)
+		Entry.Status = FGoapAgent::EStatus::NeedsPlan;
+}
+
+void FGoapRunner::SetGoal(int32 Index, const FGoapCondition& Goal)
+{
+	FGoapAgent& Entry = Agents[Index];
+	if (Entry.Goal.Mask == Goal.Mask && Entry.Goal.Values == Goal.Values)
+		return;
+
+	Entry.Goal = Goal;
+	Entry.Status = FGoapAgent::EStatus::NeedsPlan;
+}
+
+void FGoapRunner::Update(int32 IterationBudget)
+{
+	for (FGoapAgent& Entry : Agents)
+	{
+		if (!IsValid(Entry.Agent))
+			continue;
+
+		switch (Entry.Status)
+		{
+		case FGoapAgent::EStatus::NeedsPlan:
+		case FGoapAgent::EStatus::WaitingForPlan:
+			// The world state may have moved on while waiting, always ask for the plan matching the current one
+			if (!TryStartPlan(Entry))
+			{
+				Planner.RequestPlan(FGoapPlanKey{Entry.WorldState, Entry.Goal});
+				Entry.Status = FGoapAgent::EStatus::WaitingForPlan;
+			}
+			break;
+		case FGoapAgent::EStatus::Executing:
+			ExecuteStep(Entry);
+			break;
+		case FGoapAgent::EStatus::Done:
+			if (!Entry.Goal.IsMetBy(Entry.WorldState))
+				Entry.Status = FGoapAgent::EStatus::NeedsPlan;
+			break;
+		case FGoapAgent::EStatus::Failed:
+			break;
+		}
+	}
+
+	// Plans finished this frame are picked up by their agents next frame
+	Planner.Update(IterationBudget);
+}
+
+bool FGoapRunner::TryStartPlan(FGoapAgent& Entry)
+{
+	if (Entry.Goal.IsMetBy(Entry.WorldState))
+	{
+		Entry.Status = FGoapAgent::EStatus::Done;
+		return true;
+	}
+
+	const FGoapPlanKey Key{Entry.WorldState, Entry.Goal};
+	const FGoapPlan* const Plan = Planner.FindCachedPlan(Key);
+	if (!Plan)
+		return false;
+
+	// An exhausted search only fails the agents that were waiting for it, new requests and retries in flight wait
+	if (Plan->bExhausted && (Entry.Status == FGoapAgent::EStatus::NeedsPlan || Planner.IsPlanPending(Key)))
+		return false;
+
+	if (!Plan->bFound)
+	{
+		Entry.Status = FGoapAgent::EStatus::Failed;
+		return true;
+	}
+
+	Entry.Plan = Plan->Actions;
+	Entry.Step = 0;
+	Entry.bStepStarted = false;
+	Entry.Status = FGoapAgent::EStatus::Executing;
+	return true;
+}
+
+void FGoapRunner::ExecuteStep(FGoapAgent& Entry)
+{
+	const FGoapAction& Action = Definition->Actions[Entry.Plan[Entry.Step]];
+	if (!Action.Preconditions.IsMetBy(Entry.WorldState))
+	{
+		Entry.Status = FGoapAgent::EStatus::NeedsPlan;
+		return;
+	}
+
+	if (!Entry.bStepStarted)
+	{
+		if (Action.BehaviorSlot != INDEX_NONE && Entry.Behaviors[Action.BehaviorSlot])
+			Entry.Agent->SetSteeringBehavior(Entry.Behaviors[Action.BehaviorSlot]);
+		Entry.bStepStarted = true;
+	}
+
+	if (Action.IsDone && !Action.IsDone(*Entry.Agent, Entry))
+		return;
+
+	Entry.WorldState = Action.Apply(Entry.WorldState);
+	Entry.bStepStarted = false;
+
+	if (++Entry.Step == static_cast<int32>(Entry.Plan.size()))
+	{
+		Entry.Status = Entry.Goal.IsMetBy(Entry.WorldState) ? FGoapAgent::EStatus::Done : FGoapAgent::EStatus::NeedsPlan;
+	}
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <memory>
+#include <vector>
+
+class ASteeringAgent;
+class ISteeringBehavior;
+
+/*
+ * Goal-oriented action planning.
+ *
+ * World states are 64 bit sets, one bit per fact (pick an enum per definition to name them). Conditions only look at the
+ * bits in their mask, effects overwrite the bits in theirs, which makes applying and testing an action two bit operations.
+ *
+ * Plans are found with a forward A* over world states. Searches are queued and expanded a fixed number of nodes per frame,
+ * finished plans are cached by (start state, goal) so every agent in the same situation reuses them.
+ */
+using FGoapWorldState = uint64;
+
+struct FGoapCondition final
+{
+	FGoapWorldState Mask{0};
+	FGoapWorldState Values{0};
+
+	bool IsMetBy(FGoapWorldState State) const { return (State & Mask) == Values; }
+	int32 CountUnmet(FGoapWorldState State) const { return FMath::CountBits((State ^ Values) & Mask); }
+
+	void Set(int32 Fact, bool bValue)
+	{
+		check(Fact < 64);
+		Mask |= 1ull << Fact;
+		Values = bValue ? (Values | (1ull << Fact)) : (Values & ~(1ull << Fact));
+	}
+};
+
+struct FGoapAgent;
+
+// Returns true once the step has reached its goal, null means the step completes immediately
+using FGoapStepDone = bool (*)(const ASteeringAgent& Agent, const FGoapAgent& GoapAgent);
+
+struct FGoapAction final
+{
+	FName Name{};
+	float Cost{1.f};
+	FGoapCondition Preconditions{};
+	FGoapCondition Effects{};
+	int32 BehaviorSlot{INDEX_NONE}; // steering behavior the agent runs during this step
+	FGoapStepDone IsDone{nullptr};
+
+	FGoapWorldState Apply(FGoapWorldState State) const { return (State & ~Effects.Mask) | Effects.Values; }
+};
+
+// Immutable once shared between runners
+struct FGoapDefinition final
+{
+	static constexpr int32 MaxActions{255};
+
+	std::vector<FGoapAction> Actions{};
+};
+
+struct FGoapPlanKey final
+{
+	FGoapWorldState Start{0};
+	FGoapCondition Goal{};
+
+	bool operator==(const FGoapPlanKey& Other) const
+	{
+		return Start == Other.Start && Goal.Mask == Other.Goal.Mask && Goal.Values == Other.Goal.Values;
+	}
+
+	friend uint32 GetTypeHash(const FGoapPlanKey& Key)
+	{
+		return HashCombineFast(GetTypeHash(Key.Start), HashCombineFast(GetTypeHash(Key.Goal.Mask), GetTypeHash(Key.Goal.Values)));
+	}
+};
+
+struct FGoapPlan final
+{
+	bool bFound{false};
+	bool bExhausted{false}; // the search ran out of nodes, the goal may still be reachable
+	float Cost{0.f};
+	std::vector<uint8> Actions{};
+};
+
+class FGoapPlanner final
+{
+public:
+	explicit FGoapPlanner(std::shared_ptr<const FGoapDefinition> InDefinition, int32 InMaxNodes = 4096, int32 InMaxCachedPlans = 1024);
+
+	const FGoapPlan* FindCachedPlan(const FGoapPlanKey& Key) const { return Cache.Find(Key); }
+	void RequestPlan(const FGoapPlanKey& Key); // requests already queued or cached are ignored, exhausted searches are retried
+	bool IsPlanPending(const FGoapPlanKey& Key) const;
+
+	// Expands at most IterationBudget nodes, spread over as many queued searches as it takes
+	void Update(int32 IterationBudget);
+
+	int32 GetNumPendingRequests() const { return PendingRequests.Num() - PendingHead + (bSearching ? 1 : 0); }
+	void ClearCache() { Cache.Reset(); CacheOrder.Reset(); OldestCached = 0; }
+
+private:
+	struct FNode
+	{
+		FGoapWorldState State{0};
+		float G{0.f};
+		float F{0.f};
+		int32 Parent{INDEX_NONE};
+		uint8 Action{0};
+	};
+
+	std::shared_ptr<const FGoapDefinition> Definition{};
+	int32 MaxNodes{0};
+	int32 MaxCachedPlans{0};
+	float MinActionCost{1.f};
+	int32 MaxEffectBits{1};
+
+	// Search state, kept between frames. The node pool is only cleared, never shrunk, so searches don't allocate.
+	bool bSearching{false};
+	FGoapPlanKey ActiveKey{};
+	std::vector<FNode> Nodes{};
+	std::vector<int32> Open{}; // binary heap of node indices ordered on F
+	TMap<FGoapWorldState, int32> BestNodes{};
+
+	// Requests are consumed from PendingHead on, the consumed part is dropped once it makes up half of the array
+	TArray<FGoapPlanKey> PendingRequests{};
+	int32 PendingHead{0};
+
+	// Full caches evict their oldest plan, CacheOrder is a ring of the cached keys in insertion order
+	TMap<FGoapPlanKey, FGoapPlan> Cache{};
+	TArray<FGoapPlanKey> CacheOrder{};
+	int32 OldestCached{0};
+
+	void StartSearch(const FGoapPlanKey& Key);
+	// Returns true when the search finished
+	bool Expand();
+	void FinishSearch(int32 GoalNode, bool bExhausted = false);
+	float Heuristic(FGoapWorldState State) const;
+};
+
+struct FGoapAgent final
+{
+	static constexpr int32 MaxBehaviorSlots{4};
+
+	enum class EStatus : uint8
+	{
+		NeedsPlan,
+		WaitingForPlan,
+		Executing,
+		Done,
+		Failed
+	};
+
+	ASteeringAgent* Agent{nullptr}; // non-owning
+	FGoapWorldState WorldState{0};
+	FGoapCondition Goal{};
+	ISteeringBehavior* Behaviors[MaxBehaviorSlots]{}; // non-owning
+
+	EStatus Status{EStatus::NeedsPlan};
+	std::vector<uint8> Plan{};
+	int32 Step{0};
+	bool bStepStarted{false};
+};
+
+/*
+ * Plans for and executes the plans of a group of agents sharing one definition.
+ *
+ * World states are written by the owner (sensors, game logic), the runner replans whenever a step's preconditions stop
+ * holding. Every plan step switches the agent to one of its registered steering behaviors until the step is done.
+ */
+class FGoapRunner final
+{
+public:
+	explicit FGoapRunner(std::shared_ptr<const FGoapDefinition> InDefinition);
+
+	int32 AddAgent(ASteeringAgent* Agent, FGoapWorldState WorldState, const FGoapCondition& Goal);
+	void RemoveAgent(ASteeringAgent* Agent); // swaps the last agent into the removed slot
+	int32 FindAgent(const ASteeringAgent* Agent) const;
+	int32 GetNumAgents() const { return static_cast<int32>(Agents.size()); }
+
+	FGoapAgent& GetAgent(int32 Index) { return Agents[Index]; }
+	const FGoapAgent& GetAgent(int32 Index) const { return Agents[Index]; }
+	void SetWorldState(int32 Index, FGoapWorldState WorldState);
+	void SetGoal(int32 Index, const FGoapCondition& Goal);
+
+	void Update(int32 IterationBudget = 256);
+
+	FGoapPlanner& GetPlanner() { return Planner; }
+
+private:
+	std::shared_ptr<const FGoapDefinition> Definition{};
+	FGoapPlanner Planner;
+	std::vector<FGoapAgent> Agents{};
+
+	bool TryStartPlan(FGoapAgent& Entry);
+	void ExecuteStep(FGoapAgent& Entry);
+};
@@ -0,0 +1,250 @@
+#include "InfluenceMap.h"
+#include "ImGuiModule.h"
+#include "imgui.h"
+#include <algorithm>
+
+//**************
+//INFLUENCE MAP
+FInfluenceMap::FInfluenceMap(int32 InWidth, int32 InHeight, float InCellSize, const FVector2D& InOrigin)
+	: Width(InWidth)
+	, Height(InHeight)
+	, CellSize(InCellSize)
+	, Origin(InOrigin)
+	, TilesX(FMath::DivideAndRoundUp(InWidth, TileSize))
+	, TilesY(FMath::DivideAndRoundUp(InHeight, TileSize))
+	, Current(static_cast<size_t>(InWidth) * InHeight, 0.f)
+	, Next(static_cast<size_t>(InWidth) * InHeight, 0.f)
+	, ActiveTiles(static_cast<size_t>(TilesX) * TilesY, 0)
+	, TilesToProcess(static_cast<size_t>(TilesX) * TilesY, 0)
+{
+}
+
+void FInfluenceMap::Clear()
+{
+	std::fill(Current.begin(), Current.end(), 0.f);
+	std::fill(Next.begin(), Next.end(), 0.f);
+	std::fill(ActiveTiles.begin(), ActiveTiles.end(), 0);
+	TimeSinceStep = 0.f;
+}
+
+int32 FInfluenceMap::GetNumActiveTiles() const
+{
+	int32 NumActive{0};
+	for (uint8 bIsActive : ActiveTiles)
+	{
+		NumActive += bIsActive;
+	}
+	return NumActive;
+}
+
+void FInfluenceMap::Stamp(const FVector2D& Position, float Amount, float Radius)
+{
+	const FVector2D Local = (Position - Origin) / CellSize;
+	const float CellRadius = Radius / CellSize;
+
+	const int32 MinX = FMath::Max(FMath::FloorToInt(Local.X - CellRadius), 0);
+	const int32 MaxX = FMath::Min(FMath::CeilToInt(Local.X + CellRadius), Width - 1);
+	const int32 MinY = FMath::Max(FMath::FloorToInt(Local.Y - CellRadius), 0);
+	const int32 MaxY = FMath::Min(FMath::CeilToInt(Local.Y + CellRadius), Height - 1);
+
+	for (int32 Y = MinY; Y <= MaxY; ++Y)
+	{
+		for (int32 X = MinX; X <= MaxX; ++X)
+		{
+			const float Distance = FVector2D::Distance(Local, FVector2D{X + 0.5f, Y + 0.5f});
+			if (Distance > CellRadius)
+				continue;
+
+			Current[Y * Width + X] += Amount * (1.f - Distance / FMath::Max(CellRadius, KINDA_SMALL_NUMBER));
+			MarkActive(FIntPoint{X, Y});
+		}
+	}
+}
+
+float FInfluenceMap::Sample(const FVector2D& Position) const
+{
+	const FVector2D Local = (Position - Origin) / CellSize;
+	const int32 X = FMath::FloorToInt(Local.X);
+	const int32 Y = FMath::FloorToInt(Local.Y);
+
+	if (X < 0 || Y < 0 || X >= Width || Y >= Height)
+		return 0.f;
+
+	return Current[Y * Width + X];
+}
+
+void FInfluenceMap::Update(float DeltaT)
+{
+	// Fixed steps keep propagation speed independent of the frame rate, never catch up more than a few steps though
+	constexpr int MaxStepsPerUpdate{4};
+
+	TimeSinceStep = FMath::Min(TimeSinceStep + DeltaT, PropagationInterval * MaxStepsPerUpdate);
+	while (TimeSinceStep >= PropagationInterval)
+	{
+		Step(PropagationInterval);
+		TimeSinceStep -= PropagationInterval;
+	}
+}
+
+void FInfluenceMap::Step(float DeltaT)
+{
+	const float Decay = FMath::Exp(-DecayRate * DeltaT);
+	const float CenterWeight = (1.f - Spread) * Decay;
+	const float NeighborWeight = Spread * 0.25f * Decay;
+
+	// Influence spreads at most one cell per step, so only active tiles and their neighbours can change
+	for (int32 TileY{0}; TileY < TilesY; ++TileY)
+	{
+		for (int32 TileX{0}; TileX < TilesX; ++TileX)
+		{
+			const int32 Tile = TileY * TilesX + TileX;
+			TilesToProcess[Tile] = ActiveTiles[Tile]
+				|| (TileX > 0 && ActiveTiles[Tile - 1]) || (TileX + 1 < TilesX && ActiveTiles[Tile + 1])
+				|| (TileY > 0 && ActiveTiles[Tile - TilesX]) || (TileY + 1 < TilesY && ActiveTiles[Tile + TilesX]);
+		}
+	}
+
+	for (int32 Tile{0}; Tile < static_cast<int32>(TilesToProcess.size()); ++Tile)
+	{
+		if (TilesToProcess[Tile])
+		{
+			const float MaxAbs = PropagateTile(Tile % TilesX, Tile / TilesX, CenterWeight, NeighborWeight);
+			ActiveTiles[Tile] = MaxAbs >= ActivityThreshold ? 1 : 0;
+		}
+	}
+
+	// Sleeping tiles are zeroed in both buffers, after the pass so neighbours still read the old values
+	for (int32 Tile{0}; Tile < static_cast<int32>(TilesToProcess.size()); ++Tile)
+	{
+		if (TilesToProcess[Tile] && !ActiveTiles[Tile])
+			ClearTile(Tile % TilesX, Tile / TilesX);
+	}
+
+	std::swap(Current, Next);
+}
+
+float FInfluenceMap::PropagateTile(int32 TileX, int32 TileY, float CenterWeight, float NeighborWeight)
+{
+	const int32 X0 = TileX * TileSize;
+	const int32 X1 = FMath::Min(X0 + TileSize, Width);
+	const int32 Y0 = TileY * TileSize;
+	const int32 Y1 = FMath::Min(Y0 + TileSize, Height);
+
+	const VectorRegister4Float CenterW = VectorSetFloat1(CenterWeight);
+	const VectorRegister4Float NeighborW = VectorSetFloat1(NeighborWeight);
+	VectorRegister4Float MaxAbs = VectorZeroFloat();
+	float ScalarMaxAbs = 0.f;
+
+	for (int32 Y = Y0; Y < Y1; ++Y)
+	{
+		// Borders clamp to themselves
+		const float* Row = &Current[Y * Width];
+		const float* Up = &Current[FMath::Min(Y + 1, Height - 1) * Width];
+		const float* Down = &Current[FMath::Max(Y - 1, 0) * Width];
+		float* Out = &Next[Y * Width];
+
+		auto PropagateCell = [&](int32 X)
+		{
+			const float Left = Row[FMath::Max(X - 1, 0)];
+			const float Right = Row[FMath::Min(X + 1, Width - 1)];
+			Out[X] = Row[X] * CenterWeight + (Left + Right + Up[X] + Down[X]) * NeighborWeight;
+			ScalarMaxAbs = FMath::Max(ScalarMaxAbs, FMath::Abs(Out[X]));
+		};
+
+		int32 X = X0;
+		if (X == 0)
+			PropagateCell(X++);
+
+		// 4 cells at a time, the last column of the map needs the clamped (scalar) path
+		const int32 SimdEnd = FMath::Min(X1, Width - 1);
+		for (; X + 4 <= SimdEnd; X += 4)
+		{
+			const VectorRegister4Float Center = VectorLoad(Row + X);
+			const VectorRegister4Float Horizontal = VectorAdd(VectorLoad(Row + X - 1), VectorLoad(Row + X + 1));
+			const VectorRegister4Float Vertical = VectorAdd(VectorLoad(Up + X), VectorLoad(Down + X));
+			const VectorRegister4Float Value = VectorMultiplyAdd(Center, CenterW, VectorMultiply(VectorAdd(Horizontal, Vertical), NeighborW));
+
+			VectorStore(Value, Out + X);
+			MaxAbs = VectorMax(MaxAbs, VectorAbs(Value));
+		}
+
+		for (; X < X1; ++X)
+			PropagateCell(X);
+	}
+
+	alignas(16) float Lanes[4];
+	VectorStoreAligned(MaxAbs, Lanes);
+	return FMath::Max(FMath::Max(Lanes[0], Lanes[1]), FMath::Max(FMath::Max(Lanes[2], Lanes[3]), ScalarMaxAbs));
+}
+
+void FInfluenceMap::ClearTile(int32 TileX, int32 TileY)
+{
+	const int32 X0 = TileX * TileSize;
+	const int32 X1 = FMath::Min(X0 + TileSize, Width);
+	const int32 Y1 = FMath::Min((TileY + 1) * TileSize, Height);
+
+	for (int32 Y = TileY * TileSize; Y < Y1; ++Y)
+	{
+		std::fill(Current.begin() + Y * Width + X0, Current.begin() + Y * Width + X1, 0.f);
+		std::fill(Next.begin() + Y * Width + X0, Next.begin() + Y * Width + X1, 0.f);
+	}
+}
+
+//*************************
+//INFLUENCE MAP VISUALIZER
+FInfluenceMapVisualizer::FInfluenceMapVisualizer(const FName& InTextureName, const FInfluenceMap& InMap)
+	: Map(InMap)
+	, Pixels(static_cast<size_t>(InMap.GetWidth()) * InMap.GetHeight(), FColor{0, 0, 0, 0})
+{
+	TextureHandle = FImGuiModule::Get().RegisterDynamicTexture(InTextureName, Map.GetWidth(), Map.GetHeight(), PF_B8G8R8A8, true);
+}
+
+FInfluenceMapVisualizer::~FInfluenceMapVisualizer()
+{
+	// The module owns the texture
+	if (FImGuiModule::IsAvailable())
+		FImGuiModule::Get().ReleaseTexture(TextureHandle);
+}
+
+void FInfluenceMapVisualizer::UpdateTexture(float MaxValue)
+{
+	const int32 Width = Map.GetWidth();
+	const int32 Height = Map.GetHeight();
+	const float* Values = Map.GetValues();
+	const float InvMax = 1.f / FMath::Max(MaxValue, KINDA_SMALL_NUMBER);
+
+	// Positive influence is red, negative is blue. Most of the map is quiet, so only the band of changed rows is uploaded
+	int32 FirstChangedRow{Height};
+	int32 LastChangedRow{-1};
+	for (int32 y{0}; y < Height; ++y)
+	{
+		bool bRowChanged{false};
+		for (int32 x{0}; x < Width; ++x)
+		{
+			const int32 i{y * Width + x};
+			const uint8 Intensity = static_cast<uint8>(FMath::Clamp(FMath::Abs(Values[i]) * InvMax, 0.f, 1.f) * 255.f);
+			const FColor Pixel = Values[i] >= 0.f ? FColor{Intensity, 0, 0, 255} : FColor{0, 0, Intensity, 255};
+			bRowChanged |= Pixels[i] != Pixel;
+			Pixels[i] = Pixel;
+		}
+
+		if (bRowChanged)
+		{
+			FirstChangedRow = FMath::Min(FirstChangedRow, y);
+			LastChangedRow = y;
+		}
+	}
+
+	if (LastChangedRow < FirstChangedRow)
+		return;
+
+	const FIntRect Rect{0, FirstChangedRow, Width, LastChangedRow + 1};
+	FImGuiModule::Get().UpdateDynamicTexture(TextureHandle, Rect,
+		reinterpret_cast<const uint8*>(&Pixels[static_cast<size_t>(FirstChangedRow) * Width]), Width * sizeof(FColor));
+}
+
+void FInfluenceMapVisualizer::DrawImGui(float DisplayWidth) const
+{
+	const float AspectRatio = static_cast<float>(Map.GetHeight()) / Map.GetWidth();
+	ImGui::Image(TextureHandle, ImVec2{DisplayWidth, DisplayWidth * AspectRatio});
+}
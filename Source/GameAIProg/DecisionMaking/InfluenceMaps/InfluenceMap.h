@@ -0,0 +1,93 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ImGuiTextureHandle.h"
+#include <vector>
+
+/*
+ * Scalar influence field on a uniform grid (danger, ownership, ...).
+ *
+ * Agents stamp into the map every frame, propagation and decay run at a fixed rate. The grid is split in tiles and only
+ * tiles that hold influence (and their direct neighbours, where influence spreads to) are processed, the rest of the map
+ * is guaranteed to be zero and costs nothing.
+ */
+class FInfluenceMap final
+{
+public:
+	FInfluenceMap(int32 InWidth, int32 InHeight, float InCellSize, const FVector2D& InOrigin);
+
+	void Update(float DeltaT);
+	void Clear();
+
+	// Adds Amount at Position, fading out linearly up to Radius. Stamps made every frame should scale Amount by the frame
+	// time, decay runs in fixed steps
+	void Stamp(const FVector2D& Position, float Amount, float Radius);
+
+	// O(1) lookup, zero outside of the map
+	float Sample(const FVector2D& Position) const;
+
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+	float GetCellSize() const { return CellSize; }
+	const FVector2D& GetOrigin() const { return Origin; }
+	const float* GetValues() const { return Current.data(); }
+	int32 GetNumActiveTiles() const;
+
+	// Fraction of a cell's influence that flows to its 4 neighbours per propagation step
+	void SetSpread(float NewSpread) { Spread = FMath::Clamp(NewSpread, 0.f, 1.f); }
+	float GetSpread() const { return Spread; }
+	// Exponential decay rate in 1/s, influence is scaled by exp(-rate * dt) every update
+	void SetDecayRate(float NewDecayRate) { DecayRate = FMath::Max(NewDecayRate, 0.f); }
+	float GetDecayRate() const { return DecayRate; }
+	void SetPropagationInterval(float NewInterval) { PropagationInterval = FMath::Max(NewInterval, 0.001f); }
+
+private:
+	static constexpr int32 TileSize{16};
+	static constexpr float ActivityThreshold{0.001f}; // tiles below this are zeroed and go to sleep
+
+	int32 Width{0};
+	int32 Height{0};
+	float CellSize{100.f};
+	FVector2D Origin{FVector2D::ZeroVector};
+
+	int32 TilesX{0};
+	int32 TilesY{0};
+
+	std::vector<float> Current{};
+	std::vector<float> Next{};
+	std::vector<uint8> ActiveTiles{};
+	std::vector<uint8> TilesToProcess{};
+
+	float Spread{0.4f};
+	float DecayRate{0.5f};
+	float PropagationInterval{1.f / 20.f};
+	float TimeSinceStep{0.f};
+
+	void Step(float DeltaT);
+	void MarkActive(const FIntPoint& Cell) { ActiveTiles[(Cell.Y / TileSize) * TilesX + Cell.X / TileSize] = 1; }
+	float PropagateTile(int32 TileX, int32 TileY, float CenterWeight, float NeighborWeight); // returns max abs value
+	void ClearTile(int32 TileX, int32 TileY);
+};
+
+/*
+ * Renders an influence map into a dynamic ImGui texture, so it can be shown with ImGui::Image. Only rows that changed since
+ * the last upload are sent.
+ */
+class FInfluenceMapVisualizer final
+{
+public:
+	FInfluenceMapVisualizer(const FName& InTextureName, const FInfluenceMap& InMap);
+	~FInfluenceMapVisualizer();
+
+	FInfluenceMapVisualizer(const FInfluenceMapVisualizer&) = delete;
+	FInfluenceMapVisualizer& operator=(const FInfluenceMapVisualizer&) = delete;
+
+	// Uploads the current values, MaxValue maps to full color
+	void UpdateTexture(float MaxValue = 1.f);
+	void DrawImGui(float DisplayWidth) const;
+
+private:
+	const FInfluenceMap& Map;
+	FImGuiTextureHandle TextureHandle{};
+	std::vector<FColor> Pixels{}; // what the texture holds
+};
@@ -0,0 +1,232 @@
+#include "SteeringPerceptionSubsystem.h"
+#include "Async/ParallelFor.h"
+#include "Components/PrimitiveComponent.h"
+#include "EngineUtils.h"
+#include "GameAIProg/Movement/SteeringBehaviors/SteeringAgent.h"
+#include "GameAIProg/Shared/SpatialQuerySubsystem.h"
+
+void USteeringPerceptionSubsystem::RegisterAgent(ASteeringAgent* Agent, const FPerceptionConfig& Config)
+{
+	if (!IsValid(Agent))
+		return;
+
+	if (Agents.Contains(Agent))
+	{
+		SetConfig(Agent, Config);
+		return;
+	}
+
+	// Spread the first updates of agents registered together over their interval
+	const float Stagger = FMath::Fractional(Agents.Num() * 0.618034f);
+
+	Agents.Add(Agent);
+	Configs.Add(Config);
+	Results.AddDefaulted();
+	TimeUntilUpdate.Add(Stagger * Config.UpdateInterval);
+	FirstUnheardNoise.Add(NextNoiseId);
+}
+
+void USteeringPerceptionSubsystem::UnregisterAgent(ASteeringAgent* Agent)
+{
+	const int32 Index = Agents.IndexOfByKey(Agent);
+	if (Index != INDEX_NONE)
+		RemoveAgentAt(Index);
+}
+
+void USteeringPerceptionSubsystem::SetConfig(ASteeringAgent* Agent, const FPerceptionConfig& Config)
+{
+	const int32 Index = Agents.IndexOfByKey(Agent);
+	if (Index != INDEX_NONE)
+		Configs[Index] = Config;
+}
+
+void USteeringPerceptionSubsystem::ReportNoise(const FVector2D& Location, float Radius, const ASteeringAgent* Instigator)
+{
+	Noises.Add(FNoise{Location, Radius, Time, NextNoiseId++, Instigator});
+}
+
+const FPerceptionResult* USteeringPerceptionSubsystem::GetPerception(const ASteeringAgent* Agent) const
+{
+	const int32 Index = Agents.IndexOfByKey(Agent);
+	return Index != INDEX_NONE ? &Results[Index] : nullptr;
+}
+
+void USteeringPerceptionSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Agents see at the height they are spawned at, static geometry crossing it occludes (the ground stays below it)
+	constexpr float SightHeight{90.f};
+
+	Obstacles.Reset();
+	for (TActorIterator<AActor> It{&InWorld}; It; ++It)
+	{
+		It->ForEachComponent<UPrimitiveComponent>(false, [this](const UPrimitiveComponent* Primitive)
+		{
+			if (Primitive->Mobility != EComponentMobility::Static || !Primitive->IsCollisionEnabled()
+				|| Primitive->GetCollisionResponseToChannel(ECC_Visibility) != ECR_Block)
+				return;
+
+			const FBox Bounds = Primitive->Bounds.GetBox();
+			if (Bounds.Min.Z <= SightHeight && Bounds.Max.Z >= SightHeight)
+				Obstacles.AddBox(FBox2D{FVector2D{Bounds.Min}, FVector2D{Bounds.Max}});
+		});
+	}
+	Obstacles.Build();
+}
+
+void USteeringPerceptionSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	Time += DeltaTime;
+
+	// Agents destroyed without unregistering are dropped here
+	for (int32 i = Agents.Num() - 1; i >= 0; --i)
+	{
+		if (!IsValid(Agents[i]))
+			RemoveAgentAt(i);
+	}
+
+	USpatialQuerySubsystem* const Queries = GetWorld()->GetSubsystem<USpatialQuerySubsystem>();
+	if (!Queries)
+		return;
+
+	Queries->Refresh();
+	SpatialQueries = Queries;
+
+	DueAgents.Reset();
+	DueSnapshotIndices.Reset();
+
+	float MaxUpdateInterval{0.f};
+	for (int32 i{0}; i < Agents.Num(); ++i)
+	{
+		MaxUpdateInterval = FMath::Max(MaxUpdateInterval, Configs[i].UpdateInterval);
+
+		TimeUntilUpdate[i] -= DeltaTime;
+		if (TimeUntilUpdate[i] > 0.f)
+			continue;
+
+		// Never queue up more than one update, a slow frame just delays the next one
+		TimeUntilUpdate[i] = FMath::Max(TimeUntilUpdate[i] + Configs[i].UpdateInterval, 0.f);
+
+		const int32 SnapshotIndex = Queries->FindAgent(Agents[i]);
+		if (SnapshotIndex != INDEX_NONE)
+		{
+			DueAgents.Add(i);
+			DueSnapshotIndices.Add(SnapshotIndex);
+		}
+	}
+
+	constexpr int32 MinBatchSize{16};
+	ParallelFor(TEXT("SteeringPerception"), DueAgents.Num(), MinBatchSize, [this](int32 i)
+	{
+		Perceive(DueAgents[i], DueSnapshotIndices[i]);
+	});
+
+	for (const int32 Index : DueAgents)
+	{
+		if (Configs[Index].bDriveSteeringTarget)
+			ApplySteeringTarget(Index);
+	}
+
+	// Every agent has had its chance to hear these
+	const float OldestNoise = Time - MaxUpdateInterval - DeltaTime;
+	Noises.RemoveAll([OldestNoise](const FNoise& Noise) { return Noise.Time < OldestNoise; });
+}
+
+TStatId USteeringPerceptionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USteeringPerceptionSubsystem, STATGROUP_Tickables);
+}
+
+void USteeringPerceptionSubsystem::Deinitialize()
+{
+	Agents.Empty();
+	Configs.Empty();
+	Results.Empty();
+	TimeUntilUpdate.Empty();
+	FirstUnheardNoise.Empty();
+	Noises.Empty();
+	Obstacles.Reset();
+
+	Super::Deinitialize();
+}
+
+void USteeringPerceptionSubsystem::RemoveAgentAt(int32 Index)
+{
+	Agents.RemoveAtSwap(Index);
+	Configs.RemoveAtSwap(Index);
+	Results.RemoveAtSwap(Index);
+	TimeUntilUpdate.RemoveAtSwap(Index);
+	FirstUnheardNoise.RemoveAtSwap(Index);
+}
+
+void USteeringPerceptionSubsystem::Perceive(int32 Index, int32 SnapshotIndex)
+{
+	const FPerceptionConfig& Config = Configs[Index];
+	FPerceptionResult& Result = Results[Index];
+	const FVector2D& Position = SpatialQueries->GetPosition(SnapshotIndex);
+
+	//Sight, candidates come closest first so crowds beyond the candidate limit can't hide the closest agent
+	int32 Candidates[FSpatialHash::MaxNearest];
+	const int32 NumCandidates = SpatialQueries->QueryConeNearest(Position, SpatialQueries->GetForward(SnapshotIndex), Config.SightHalfAngle,
+		FSpatialHash::MaxNearest, Config.SightRange, Candidates, SnapshotIndex);
+
+	Result.NumSeen = 0;
+	for (int32 i{0}; i < NumCandidates && Result.NumSeen < FPerceptionResult::MaxSeen; ++i)
+	{
+		if (!Obstacles.IsBlocked(Position, SpatialQueries->GetPosition(Candidates[i])))
+			Result.Seen[Result.NumSeen++] = SpatialQueries->GetAgent(Candidates[i]);
+	}
+	Result.ClosestSeen = Result.NumSeen > 0 ? 0 : INDEX_NONE;
+
+	//Hearing, the loudest noise (relative to its range) since the last update wins
+	float BestMargin{0.f};
+	Result.bHeardNoise = false;
+	for (const FNoise& Noise : Noises)
+	{
+		if (Noise.Id < FirstUnheardNoise[Index] || Noise.Instigator == SpatialQueries->GetAgent(SnapshotIndex))
+			continue;
+
+		const float Range = FMath::Min(Noise.Radius, Config.HearingRange);
+		const float Margin = Range - FVector2D::Distance(Noise.Location, Position);
+		if (Margin >= BestMargin)
+		{
+			BestMargin = Margin;
+			Result.bHeardNoise = true;
+			Result.NoiseLocation = Noise.Location;
+		}
+	}
+
+	FirstUnheardNoise[Index] = NextNoiseId;
+	Result.LastUpdateTime = Time;
+}
+
+void USteeringPerceptionSubsystem::ApplySteeringTarget(int32 Index) const
+{
+	const FPerceptionResult& Result = Results[Index];
+	ISteeringBehavior* const Behavior = Agents[Index]->GetSteeringBehavior();
+	if (!Behavior)
+		return;
+
+	if (Result.ClosestSeen != INDEX_NONE)
+	{
+		const ASteeringAgent* const TargetAgent = Result.Seen[Result.ClosestSeen];
+
+		FTargetData Target;
+		Target.Position = TargetAgent->GetPosition();
+		Target.Orientation = TargetAgent->GetRotation();
+		Target.LinearVelocity = TargetAgent->GetLinearVelocity();
+		Target.AngularVelocity = TargetAgent->GetAngularVelocity();
+
+		Behavior->SetTarget(Target);
+	}
+	else if (Result.bHeardNoise)
+	{
+		FTargetData Target;
+		Target.Position = Result.NoiseLocation;
+
+		Behavior->SetTarget(Target);
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameAIProg/Shared/ObstacleIndex.h"
+#include "SteeringPerceptionSubsystem.generated.h"
+
+class ASteeringAgent;
+class USpatialQuerySubsystem;
+
+struct FPerceptionConfig final
+{
+	float SightRange{1500.f};
+	float SightHalfAngle{60.f}; // degrees either side of the agent's forward
+	float HearingRange{2000.f};
+	float UpdateInterval{0.2f};
+	bool bDriveSteeringTarget{false}; // aims the agent's steering behavior at what it perceived
+};
+
+struct FPerceptionResult final
+{
+	static constexpr int32 MaxSeen{16};
+
+	ASteeringAgent* Seen[MaxSeen]{}; // non-owning, only valid until the next update
+	int32 NumSeen{0};
+	int32 ClosestSeen{INDEX_NONE};
+
+	bool bHeardNoise{false};
+	FVector2D NoiseLocation{FVector2D::ZeroVector};
+
+	float LastUpdateTime{0.f};
+};
+
+/*
+ * Sight and hearing for steering agents.
+ *
+ * Candidates come from the shared USpatialQuerySubsystem snapshot, so every steering agent can be seen, not just the
+ * registered ones. Registered agents are updated at their own rate: the ones due this frame are evaluated in batches on
+ * worker threads, which only read the snapshot and the static obstacle index. Results (and steering targets) are
+ * applied on the game thread.
+ */
+UCLASS()
+class GAMEAIPROG_API USteeringPerceptionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterAgent(ASteeringAgent* Agent, const FPerceptionConfig& Config = {});
+	void UnregisterAgent(ASteeringAgent* Agent);
+	void SetConfig(ASteeringAgent* Agent, const FPerceptionConfig& Config);
+
+	// Heard by every agent within both Radius and its own hearing range until it next updates
+	void ReportNoise(const FVector2D& Location, float Radius, const ASteeringAgent* Instigator = nullptr);
+
+	const FPerceptionResult* GetPerception(const ASteeringAgent* Agent) const;
+	int32 GetNumAgents() const { return Agents.Num(); }
+
+	// Static occluders, gathered from the level's blocking geometry when play begins. Call Build on it after adding more
+	FObstacleIndex& GetObstacles() { return Obstacles; }
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+private:
+	struct FNoise
+	{
+		FVector2D Location;
+		float Radius;
+		float Time;
+		uint32 Id;
+		const ASteeringAgent* Instigator;
+	};
+
+	UPROPERTY()
+	TArray<TObjectPtr<ASteeringAgent>> Agents;
+
+	TArray<FPerceptionConfig> Configs;
+	TArray<FPerceptionResult> Results;
+	TArray<float> TimeUntilUpdate;
+	TArray<uint32> FirstUnheardNoise;
+
+	// Agents due this frame and their index in the spatial query snapshot
+	TArray<int32> DueAgents;
+	TArray<int32> DueSnapshotIndices;
+	const USpatialQuerySubsystem* SpatialQueries{nullptr};
+
+	TArray<FNoise> Noises;
+	uint32 NextNoiseId{0};
+	FObstacleIndex Obstacles{};
+	float Time{0.f};
+
+	void RemoveAgentAt(int32 Index);
+	void Perceive(int32 Index, int32 SnapshotIndex);
+	void ApplySteeringTarget(int32 Index) const;
+};
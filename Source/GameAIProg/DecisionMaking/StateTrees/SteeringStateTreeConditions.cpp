@@ -0,0 +1,24 @@
+#include "SteeringStateTreeConditions.h"
+#include "StateTreeExecutionContext.h"
+#include "GameAIProg/Movement/SteeringBehaviors/SteeringAgent.h"
+
+bool FSteeringConditionTargetInRange::TestCondition(FStateTreeExecutionContext& Context) const
+{
+	const FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+	if (!IsValid(InstanceData.Agent))
+		return false;
+
+	const bool bInRange = FVector2D::DistSquared(InstanceData.Agent->GetPosition(), InstanceData.Target.Resolve())
+		<= FMath::Square(InstanceData.Distance);
+	return bInRange ^ bInvert;
+}
+
+bool FSteeringConditionIsMoving::TestCondition(FStateTreeExecutionContext& Context) const
+{
+	const FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+	if (!IsValid(InstanceData.Agent))
+		return false;
+
+	const bool bIsMoving = InstanceData.Agent->GetLinearVelocity().SizeSquared() > FMath::Square(InstanceData.MinSpeed);
+	return bIsMoving ^ bInvert;
+}
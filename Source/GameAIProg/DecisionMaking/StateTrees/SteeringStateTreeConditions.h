@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StateTreeConditionBase.h"
+#include "SteeringStateTreeTasks.h"
+#include "SteeringStateTreeConditions.generated.h"
+
+class ASteeringAgent;
+
+USTRUCT()
+struct GAMEAIPROG_API FSteeringConditionDistanceInstanceData
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<ASteeringAgent> Agent = nullptr;
+
+	UPROPERTY(EditAnywhere, Category = Input)
+	FSteeringTaskTarget Target;
+
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = "0.0"))
+	float Distance = 300.f;
+};
+
+// Passes when the agent is within Distance of the target
+USTRUCT(meta = (DisplayName = "Target In Range", Category = "Steering"))
+struct GAMEAIPROG_API FSteeringConditionTargetInRange : public FStateTreeConditionCommonBase
+{
+	GENERATED_BODY()
+
+	using FInstanceDataType = FSteeringConditionDistanceInstanceData;
+
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	bool bInvert = false;
+
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+	virtual bool TestCondition(FStateTreeExecutionContext& Context) const override;
+};
+
+USTRUCT()
+struct GAMEAIPROG_API FSteeringConditionMovingInstanceData
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<ASteeringAgent> Agent = nullptr;
+
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = "0.0"))
+	float MinSpeed = 10.f;
+};
+
+// Passes when the agent moves faster than MinSpeed
+USTRUCT(meta = (DisplayName = "Agent Is Moving", Category = "Steering"))
+struct GAMEAIPROG_API FSteeringConditionIsMoving : public FStateTreeConditionCommonBase
+{
+	GENERATED_BODY()
+
+	using FInstanceDataType = FSteeringConditionMovingInstanceData;
+
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	bool bInvert = false;
+
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+	virtual bool TestCondition(FStateTreeExecutionContext& Context) const override;
+};
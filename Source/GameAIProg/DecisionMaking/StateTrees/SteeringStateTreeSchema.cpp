@@ -0,0 +1,32 @@
+#include "SteeringStateTreeSchema.h"
+#include "StateTreeConditionBase.h"
+#include "StateTreeEvaluatorBase.h"
+#include "StateTreeTaskBase.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameAIProg/Movement/SteeringBehaviors/SteeringAgent.h"
+
+const FName USteeringStateTreeSchema::AgentContextName{TEXT("Agent")};
+
+USteeringStateTreeSchema::USteeringStateTreeSchema()
+{
+	// Fixed guid so bindings to the agent survive edits of the schema
+	ContextDataDescs.Emplace(AgentContextName, ASteeringAgent::StaticClass(), FGuid{0x5E1A2C71, 0x4B8D4F03, 0x9A61E2D4, 0x7C03B5F8});
+}
+
+bool USteeringStateTreeSchema::IsStructAllowed(const UScriptStruct* InScriptStruct) const
+{
+	return InScriptStruct->IsChildOf(FStateTreeConditionCommonBase::StaticStruct())
+		|| InScriptStruct->IsChildOf(FStateTreeEvaluatorCommonBase::StaticStruct())
+		|| InScriptStruct->IsChildOf(FStateTreeTaskCommonBase::StaticStruct());
+}
+
+bool USteeringStateTreeSchema::IsClassAllowed(const UClass* InClass) const
+{
+	return IsChildOfBlueprintBase(InClass);
+}
+
+bool USteeringStateTreeSchema::IsExternalItemAllowed(const UStruct& InStruct) const
+{
+	return InStruct.IsChildOf(AActor::StaticClass())
+		|| InStruct.IsChildOf(UWorldSubsystem::StaticClass());
+}
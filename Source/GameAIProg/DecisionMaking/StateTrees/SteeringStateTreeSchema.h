@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StateTreeSchema.h"
+#include "SteeringStateTreeSchema.generated.h"
+
+/*
+ * Schema for StateTrees that drive an ASteeringAgent.
+ *
+ * The only context data is the agent itself, so one StateTree asset can be shared by any number of agents, each with
+ * its own instance data (see USteeringStateTreeSubsystem).
+ */
+UCLASS(BlueprintType, EditInlineNew, CollapseCategories, meta = (DisplayName = "Steering Agent"))
+class GAMEAIPROG_API USteeringStateTreeSchema : public UStateTreeSchema
+{
+	GENERATED_BODY()
+
+public:
+	USteeringStateTreeSchema();
+
+	static const FName AgentContextName;
+
+protected:
+	virtual bool IsStructAllowed(const UScriptStruct* InScriptStruct) const override;
+	virtual bool IsClassAllowed(const UClass* InClass) const override;
+	virtual bool IsExternalItemAllowed(const UStruct& InStruct) const override;
+	virtual TConstArrayView<FStateTreeExternalDataDesc> GetContextDataDescs() const override { return ContextDataDescs; }
+
+	UPROPERTY()
+	TArray<FStateTreeExternalDataDesc> ContextDataDescs;
+};
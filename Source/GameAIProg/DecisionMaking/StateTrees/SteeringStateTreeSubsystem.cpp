@@ -0,0 +1,137 @@
+#include "SteeringStateTreeSubsystem.h"
+#include "StateTree.h"
+#include "StateTreeExecutionContext.h"
+#include "SteeringStateTreeSchema.h"
+#include "GameAIProg/GameAIProg.h"
+#include "GameAIProg/Movement/SteeringBehaviors/SteeringAgent.h"
+
+bool USteeringStateTreeSubsystem::RegisterAgent(ASteeringAgent* Agent, UStateTree* StateTree)
+{
+	if (!IsValid(Agent) || !IsValid(StateTree))
+		return false;
+
+	if (!StateTree->GetSchema() || !StateTree->GetSchema()->IsA<USteeringStateTreeSchema>())
+	{
+		UE_LOG(LogGameAIProg, Warning, TEXT("StateTree '%s' does not use the Steering Agent schema"), *StateTree->GetName());
+		return false;
+	}
+
+	UnregisterAgent(Agent);
+
+	FSteeringStateTreeGroup& Group = FindOrAddGroup(StateTree);
+	Group.Agents.Add(Agent);
+	FStateTreeInstanceData& InstanceData = Group.InstanceData.AddDefaulted_GetRef();
+
+	FStateTreeExecutionContext Context(*this, *StateTree, InstanceData);
+	if (!SetupContext(Context, Agent))
+	{
+		Group.Agents.Pop();
+		Group.InstanceData.Pop();
+		return false;
+	}
+
+	Context.Start();
+	return true;
+}
+
+void USteeringStateTreeSubsystem::UnregisterAgent(ASteeringAgent* Agent)
+{
+	for (FSteeringStateTreeGroup& Group : Groups)
+	{
+		const int32 Index = Group.Agents.IndexOfByKey(Agent);
+		if (Index != INDEX_NONE)
+		{
+			StopAgent(Group, Index);
+			Group.Agents.RemoveAtSwap(Index);
+			Group.InstanceData.RemoveAtSwap(Index);
+			return;
+		}
+	}
+}
+
+int32 USteeringStateTreeSubsystem::GetNumAgents() const
+{
+	int32 NumAgents{0};
+	for (const FSteeringStateTreeGroup& Group : Groups)
+	{
+		NumAgents += Group.Agents.Num();
+	}
+	return NumAgents;
+}
+
+void USteeringStateTreeSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	for (FSteeringStateTreeGroup& Group : Groups)
+	{
+		for (int32 i = Group.Agents.Num() - 1; i >= 0; --i)
+		{
+			ASteeringAgent* const Agent = Group.Agents[i];
+
+			// Agents destroyed without unregistering are dropped here
+			if (!IsValid(Agent))
+			{
+				Group.Agents.RemoveAtSwap(i);
+				Group.InstanceData.RemoveAtSwap(i);
+				continue;
+			}
+
+			FStateTreeExecutionContext Context(*this, *Group.StateTree, Group.InstanceData[i]);
+			if (SetupContext(Context, Agent))
+			{
+				Context.Tick(DeltaTime);
+			}
+		}
+	}
+}
+
+TStatId USteeringStateTreeSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USteeringStateTreeSubsystem, STATGROUP_Tickables);
+}
+
+void USteeringStateTreeSubsystem::Deinitialize()
+{
+	for (FSteeringStateTreeGroup& Group : Groups)
+	{
+		for (int32 i{0}; i < Group.Agents.Num(); ++i)
+		{
+			StopAgent(Group, i);
+		}
+	}
+	Groups.Empty();
+
+	Super::Deinitialize();
+}
+
+FSteeringStateTreeGroup& USteeringStateTreeSubsystem::FindOrAddGroup(UStateTree* StateTree)
+{
+	for (FSteeringStateTreeGroup& Group : Groups)
+	{
+		if (Group.StateTree == StateTree)
+			return Group;
+	}
+
+	FSteeringStateTreeGroup& Group = Groups.AddDefaulted_GetRef();
+	Group.StateTree = StateTree;
+	return Group;
+}
+
+void USteeringStateTreeSubsystem::StopAgent(FSteeringStateTreeGroup& Group, int32 Index)
+{
+	FStateTreeExecutionContext Context(*this, *Group.StateTree, Group.InstanceData[Index]);
+	if (SetupContext(Context, Group.Agents[Index]))
+	{
+		Context.Stop();
+	}
+}
+
+bool USteeringStateTreeSubsystem::SetupContext(FStateTreeExecutionContext& Context, ASteeringAgent* Agent) const
+{
+	if (!Context.IsValid() || !IsValid(Agent))
+		return false;
+
+	Context.SetContextDataByName(USteeringStateTreeSchema::AgentContextName, FStateTreeDataView(Agent));
+	return Context.AreContextDataViewsValid();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StateTreeInstanceData.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SteeringStateTreeSubsystem.generated.h"
+
+class ASteeringAgent;
+class UStateTree;
+struct FStateTreeExecutionContext;
+
+// All agents running the same StateTree asset, instance data is stored next to the agents
+USTRUCT()
+struct FSteeringStateTreeGroup
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UStateTree> StateTree = nullptr;
+
+	UPROPERTY()
+	TArray<TObjectPtr<ASteeringAgent>> Agents;
+
+	UPROPERTY()
+	TArray<FStateTreeInstanceData> InstanceData;
+};
+
+/*
+ * Runs StateTree logic for steering agents without a UStateTreeComponent per agent.
+ *
+ * Agents are grouped by StateTree asset (which must use USteeringStateTreeSchema). The subsystem ticks once per frame and
+ * walks every group in one tight loop, only the per-agent instance data differs between agents of a group.
+ */
+UCLASS()
+class GAMEAIPROG_API USteeringStateTreeSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	bool RegisterAgent(ASteeringAgent* Agent, UStateTree* StateTree);
+	void UnregisterAgent(ASteeringAgent* Agent);
+
+	int32 GetNumAgents() const;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+private:
+	UPROPERTY()
+	TArray<FSteeringStateTreeGroup> Groups;
+
+	FSteeringStateTreeGroup& FindOrAddGroup(UStateTree* StateTree);
+	void StopAgent(FSteeringStateTreeGroup& Group, int32 Index);
+	bool SetupContext(FStateTreeExecutionContext& Context, ASteeringAgent* Agent) const;
+};
@@ -0,0 +1,157 @@
+#include "SteeringStateTreeTasks.h"
+#include "StateTreeExecutionContext.h"
+#include "GameAIProg/Movement/SteeringBehaviors/SteeringAgent.h"
+#include "GameAIProg/Movement/SteeringBehaviors/CombinedSteering/CombinedSteeringBehaviors.h"
+
+TSharedPtr<ISteeringBehavior> MakeSteeringBehavior(ESteeringBehaviorType Type)
+{
+	switch (Type)
+	{
+	case ESteeringBehaviorType::Seek:
+		return MakeShared<Seek>();
+	case ESteeringBehaviorType::Flee:
+		return MakeShared<Flee>();
+	case ESteeringBehaviorType::Arrive:
+		return MakeShared<Arrive>();
+	case ESteeringBehaviorType::Face:
+		return MakeShared<Face>();
+	case ESteeringBehaviorType::Pursuit:
+		return MakeShared<Pursuit>();
+	case ESteeringBehaviorType::Evade:
+		return MakeShared<Evade>();
+	case ESteeringBehaviorType::Wander:
+		return MakeShared<Wander>();
+	default:
+		assert(false); // Unknown behavior type
+		return nullptr;
+	}
+}
+
+FVector2D FSteeringTaskTarget::Resolve() const
+{
+	if (IsValid(TargetActor))
+		return FVector2D{TargetActor->GetActorLocation()};
+
+	return Position;
+}
+
+namespace
+{
+	void AimBehavior(ISteeringBehavior& Behavior, const FSteeringTaskTarget& Target)
+	{
+		FTargetData TargetData;
+		TargetData.Position = Target.Resolve();
+		Behavior.SetTarget(TargetData);
+	}
+}
+
+//**********************
+//SET STEERING BEHAVIOR
+EStateTreeRunStatus FSteeringTaskSetBehavior::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+	if (!IsValid(InstanceData.Agent))
+		return EStateTreeRunStatus::Failed;
+
+	InstanceData.ActiveBehavior = MakeSteeringBehavior(InstanceData.Behavior);
+	AimBehavior(*InstanceData.ActiveBehavior, InstanceData.Target);
+	InstanceData.Agent->SetSteeringBehavior(InstanceData.ActiveBehavior.Get());
+
+	return EStateTreeRunStatus::Running;
+}
+
+EStateTreeRunStatus FSteeringTaskSetBehavior::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
+{
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+	if (!IsValid(InstanceData.Agent) || !InstanceData.ActiveBehavior)
+		return EStateTreeRunStatus::Failed;
+
+	AimBehavior(*InstanceData.ActiveBehavior, InstanceData.Target);
+	return EStateTreeRunStatus::Running;
+}
+
+void FSteeringTaskSetBehavior::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	// Only clear the agent's behavior if nobody replaced it in the meantime
+	if (IsValid(InstanceData.Agent) && InstanceData.Agent->GetSteeringBehavior() == InstanceData.ActiveBehavior.Get())
+		InstanceData.Agent->SetSteeringBehavior(nullptr);
+
+	InstanceData.ActiveBehavior.Reset();
+}
+
+//********************
+//SET STEERING TARGET
+EStateTreeRunStatus FSteeringTaskSetTarget::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	return Tick(Context, 0.f);
+}
+
+EStateTreeRunStatus FSteeringTaskSetTarget::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
+{
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+	if (!IsValid(InstanceData.Agent))
+		return EStateTreeRunStatus::Failed;
+
+	if (ISteeringBehavior* const Behavior = InstanceData.Agent->GetSteeringBehavior())
+		AimBehavior(*Behavior, InstanceData.Target);
+
+	return EStateTreeRunStatus::Running;
+}
+
+//*****************
+//BLENDED STEERING
+EStateTreeRunStatus FSteeringTaskBlended::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+	if (!IsValid(InstanceData.Agent) || InstanceData.Behaviors.IsEmpty())
+		return EStateTreeRunStatus::Failed;
+
+	std::vector<BlendedSteering::WeightedBehavior> WeightedBehaviors{};
+	InstanceData.ChildBehaviors.Reset(InstanceData.Behaviors.Num());
+	for (const FSteeringTaskWeightedBehavior& Entry : InstanceData.Behaviors)
+	{
+		TSharedPtr<ISteeringBehavior> Behavior = MakeSteeringBehavior(Entry.Behavior);
+		AimBehavior(*Behavior, InstanceData.Target);
+		WeightedBehaviors.emplace_back(Behavior.Get(), Entry.Weight);
+		InstanceData.ChildBehaviors.Add(MoveTemp(Behavior));
+	}
+
+	InstanceData.Blended = MakeShared<BlendedSteering>(WeightedBehaviors);
+	InstanceData.Agent->SetSteeringBehavior(InstanceData.Blended.Get());
+
+	return EStateTreeRunStatus::Running;
+}
+
+EStateTreeRunStatus FSteeringTaskBlended::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
+{
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+	if (!IsValid(InstanceData.Agent) || !InstanceData.Blended)
+		return EStateTreeRunStatus::Failed;
+
+	std::vector<BlendedSteering::WeightedBehavior>& WeightedBehaviors = InstanceData.Blended->GetWeightedBehaviorsRef();
+	const int32 NumWeights = FMath::Min(InstanceData.Behaviors.Num(), static_cast<int32>(WeightedBehaviors.size()));
+	for (int32 i{0}; i < NumWeights; ++i)
+	{
+		WeightedBehaviors[i].Weight = InstanceData.Behaviors[i].Weight;
+	}
+
+	for (const TSharedPtr<ISteeringBehavior>& Behavior : InstanceData.ChildBehaviors)
+	{
+		AimBehavior(*Behavior, InstanceData.Target);
+	}
+
+	return EStateTreeRunStatus::Running;
+}
+
+void FSteeringTaskBlended::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	if (IsValid(InstanceData.Agent) && InstanceData.Agent->GetSteeringBehavior() == InstanceData.Blended.Get())
+		InstanceData.Agent->SetSteeringBehavior(nullptr);
+
+	InstanceData.Blended.Reset();
+	InstanceData.ChildBehaviors.Reset();
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StateTreeTaskBase.h"
+#include "SteeringStateTreeTasks.generated.h"
+
+class ASteeringAgent;
+class ISteeringBehavior;
+class BlendedSteering;
+
+UENUM(BlueprintType)
+enum class ESteeringBehaviorType : uint8
+{
+	Seek,
+	Flee,
+	Arrive,
+	Face,
+	Pursuit,
+	Evade,
+	Wander
+};
+
+// Target of a steering task: the actor if one is bound, the position otherwise
+USTRUCT(BlueprintType)
+struct GAMEAIPROG_API FSteeringTaskTarget
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = Input)
+	TObjectPtr<AActor> TargetActor = nullptr;
+
+	UPROPERTY(EditAnywhere, Category = Input)
+	FVector2D Position = FVector2D::ZeroVector;
+
+	FVector2D Resolve() const;
+};
+
+//**********************
+//SET STEERING BEHAVIOR
+USTRUCT()
+struct GAMEAIPROG_API FSteeringTaskSetBehaviorInstanceData
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<ASteeringAgent> Agent = nullptr;
+
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	ESteeringBehaviorType Behavior = ESteeringBehaviorType::Seek;
+
+	UPROPERTY(EditAnywhere, Category = Input)
+	FSteeringTaskTarget Target;
+
+	TSharedPtr<ISteeringBehavior> ActiveBehavior{}; // per agent, created on enter
+};
+
+// Runs one of the steering behaviors on the agent for as long as the state is active
+USTRUCT(meta = (DisplayName = "Set Steering Behavior", Category = "Steering"))
+struct GAMEAIPROG_API FSteeringTaskSetBehavior : public FStateTreeTaskCommonBase
+{
+	GENERATED_BODY()
+
+	using FInstanceDataType = FSteeringTaskSetBehaviorInstanceData;
+
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
+	virtual void ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+};
+
+//*******************
+//SET STEERING TARGET
+USTRUCT()
+struct GAMEAIPROG_API FSteeringTaskSetTargetInstanceData
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<ASteeringAgent> Agent = nullptr;
+
+	UPROPERTY(EditAnywhere, Category = Input)
+	FSteeringTaskTarget Target;
+};
+
+// Retargets whatever behavior the agent is currently running (e.g. one set by a parent state)
+USTRUCT(meta = (DisplayName = "Set Steering Target", Category = "Steering"))
+struct GAMEAIPROG_API FSteeringTaskSetTarget : public FStateTreeTaskCommonBase
+{
+	GENERATED_BODY()
+
+	using FInstanceDataType = FSteeringTaskSetTargetInstanceData;
+
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
+};
+
+//*****************
+//BLENDED STEERING
+USTRUCT(BlueprintType)
+struct GAMEAIPROG_API FSteeringTaskWeightedBehavior
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	ESteeringBehaviorType Behavior = ESteeringBehaviorType::Seek;
+
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = "0.0"))
+	float Weight = 1.f;
+};
+
+USTRUCT()
+struct GAMEAIPROG_API FSteeringTaskBlendedInstanceData
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<ASteeringAgent> Agent = nullptr;
+
+	// Weights are re-applied every tick, bind them to drive the blend from other tasks or evaluators
+	UPROPERTY(EditAnywhere, Category = Input)
+	TArray<FSteeringTaskWeightedBehavior> Behaviors;
+
+	UPROPERTY(EditAnywhere, Category = Input)
+	FSteeringTaskTarget Target;
+
+	TArray<TSharedPtr<ISteeringBehavior>> ChildBehaviors{};
+	TSharedPtr<BlendedSteering> Blended{};
+};
+
+// Runs a BlendedSteering of the configured behaviors, all aimed at the same target
+USTRUCT(meta = (DisplayName = "Blended Steering", Category = "Steering"))
+struct GAMEAIPROG_API FSteeringTaskBlended : public FStateTreeTaskCommonBase
+{
+	GENERATED_BODY()
+
+	using FInstanceDataType = FSteeringTaskBlendedInstanceData;
+
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
+	virtual void ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+};
+
+// Creates a fresh behavior of the given type
+GAMEAIPROG_API TSharedPtr<ISteeringBehavior> MakeSteeringBehavior(ESteeringBehaviorType Type);
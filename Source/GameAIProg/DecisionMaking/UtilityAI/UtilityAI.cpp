@@ -0,0 +1,262 @@
+#include "UtilityAI.h"
+#include "GameAIProg/Movement/SteeringBehaviors/SteeringAgent.h"
+#include "GameAIProg/Movement/SteeringBehaviors/CombinedSteering/CombinedSteeringBehaviors.h"
+#include <algorithm>
+
+//***************
+//RESPONSE CURVE
+FResponseCurve::FResponseCurve(EType InType, float InMinInput, float InMaxInput, float Slope, float Exponent, float XShift, float YShift)
+	: MinInput(InMinInput)
+	, InputToTable((TableSize - 1) / FMath::Max(InMaxInput - InMinInput, KINDA_SMALL_NUMBER))
+{
+	for (int32 i{0}; i < TableSize; ++i)
+	{
+		const float X = static_cast<float>(i) / (TableSize - 1);
+
+		float Y{0.f};
+		switch (InType)
+		{
+		case EType::Linear:
+			Y = Slope * (X - XShift) + YShift;
+			break;
+		case EType::Polynomial:
+			Y = Slope * FMath::Pow(FMath::Max(X - XShift, 0.f), Exponent) + YShift;
+			break;
+		case EType::Logistic:
+			Y = Slope / (1.f + FMath::Exp(-Exponent * (X - XShift))) + YShift;
+			break;
+		}
+
+		Table[i] = FMath::Clamp(Y, 0.f, 1.f);
+	}
+	Table[TableSize] = Table[TableSize - 1];
+}
+
+float FResponseCurve::Evaluate(float Input) const
+{
+	const float T = FMath::Clamp((Input - MinInput) * InputToTable, 0.f, TableSize - 1.f);
+	const int32 Index = static_cast<int32>(T);
+	return FMath::Lerp(Table[Index], Table[Index + 1], T - Index);
+}
+
+void FResponseCurve::EvaluateBatch(const float* Inputs, float* OutScores, int32 Count) const
+{
+	check(Count % 4 == 0);
+
+	const VectorRegister4Float Min = VectorSetFloat1(MinInput);
+	const VectorRegister4Float Scale = VectorSetFloat1(InputToTable);
+	const VectorRegister4Float LastIndex = VectorSetFloat1(TableSize - 1.f);
+
+	alignas(16) float Indices[4];
+	alignas(16) float Lower[4];
+	alignas(16) float Upper[4];
+
+	for (int32 i{0}; i < Count; i += 4)
+	{
+		VectorRegister4Float T = VectorMultiply(VectorSubtract(VectorLoad(Inputs + i), Min), Scale);
+		T = VectorMin(VectorMax(T, VectorZeroFloat()), LastIndex);
+
+		// T is never negative here, truncating is flooring
+		const VectorRegister4Float Index = VectorTruncate(T);
+		VectorStoreAligned(Index, Indices);
+
+		// No gather instruction to rely on, the table reads stay scalar
+		for (int32 Lane{0}; Lane < 4; ++Lane)
+		{
+			const int32 TableIndex = static_cast<int32>(Indices[Lane]);
+			Lower[Lane] = Table[TableIndex];
+			Upper[Lane] = Table[TableIndex + 1];
+		}
+
+		const VectorRegister4Float Low = VectorLoadAligned(Lower);
+		const VectorRegister4Float High = VectorLoadAligned(Upper);
+		VectorStore(VectorMultiplyAdd(VectorSubtract(High, Low), VectorSubtract(T, Index), Low), OutScores + i);
+	}
+}
+
+//***************
+//UTILITY RUNNER
+FUtilityRunner::FUtilityRunner(std::shared_ptr<const FUtilityDefinition> InDefinition)
+	: Definition(std::move(InDefinition))
+{
+	check(Definition);
+}
+
+int32 FUtilityRunner::AddAgent(ASteeringAgent* Agent, BlendedSteering* Blended)
+{
+	const int32 NumActions = static_cast<int32>(Definition->Actions.size());
+
+	Agents.push_back(Agent);
+	BlendedBehaviors.push_back(Blended);
+	ActionBehaviors.resize(ActionBehaviors.size() + NumActions, nullptr);
+	CurrentActions.push_back(INDEX_NONE);
+
+	Resize(NumAgents + 1);
+	return NumAgents - 1;
+}
+
+void FUtilityRunner::RemoveAgent(ASteeringAgent* Agent)
+{
+	const int32 Index = FindAgent(Agent);
+	if (Index == INDEX_NONE)
+		return;
+
+	const int32 Last = NumAgents - 1;
+	const int32 NumActions = static_cast<int32>(Definition->Actions.size());
+
+	Agents[Index] = Agents[Last];
+	BlendedBehaviors[Index] = BlendedBehaviors[Last];
+	CurrentActions[Index] = CurrentActions[Last];
+	std::copy_n(ActionBehaviors.begin() + Last * NumActions, NumActions, ActionBehaviors.begin() + Index * NumActions);
+	for (int32 Channel{0}; Channel < Definition->NumInputChannels; ++Channel)
+	{
+		float* const Row = GetInputChannel(Channel);
+		Row[Index] = Row[Last];
+		Row[Last] = 0.f;
+	}
+
+	Agents.pop_back();
+	BlendedBehaviors.pop_back();
+	CurrentActions.pop_back();
+	ActionBehaviors.resize(ActionBehaviors.size() - NumActions);
+
+	Resize(Last);
+}
+
+int32 FUtilityRunner::FindAgent(const ASteeringAgent* Agent) const
+{
+	const auto It = std::find(Agents.begin(), Agents.end(), Agent);
+	return It != Agents.end() ? static_cast<int32>(It - Agents.begin()) : INDEX_NONE;
+}
+
+void FUtilityRunner::SetActionBehavior(int32 AgentIndex, int32 ActionIndex, ISteeringBehavior* Behavior)
+{
+	ActionBehaviors[AgentIndex * Definition->Actions.size() + ActionIndex] = Behavior;
+}
+
+void FUtilityRunner::Update()
+{
+	if (NumAgents == 0 || Definition->Actions.empty())
+		return;
+
+	ScoreActions();
+	PickWinners();
+
+	for (int32 i{0}; i < NumAgents; ++i)
+	{
+		const int32 Winner = static_cast<int32>(BestActions[i]);
+		if (Winner != CurrentActions[i])
+			ApplyAction(i, Winner);
+	}
+}
+
+void FUtilityRunner::Resize(int32 NewNumAgents)
+{
+	const int32 NewStride = Align(NewNumAgents, 4);
+	if (NewStride != Stride)
+	{
+		// The padding lanes stay zero, they are scored like any agent but never read back
+		std::vector<float> NewInputs(static_cast<size_t>(Definition->NumInputChannels) * NewStride, 0.f);
+		const int32 NumToCopy = FMath::Min(NumAgents, NewNumAgents);
+		for (int32 Channel{0}; Channel < Definition->NumInputChannels; ++Channel)
+		{
+			std::copy_n(Inputs.begin() + Channel * Stride, NumToCopy, NewInputs.begin() + Channel * NewStride);
+		}
+
+		Inputs = std::move(NewInputs);
+		Scores.resize(Definition->Actions.size() * NewStride);
+		ConsiderationScratch.resize(NewStride);
+		BestActions.resize(NewStride);
+		Stride = NewStride;
+	}
+
+	NumAgents = NewNumAgents;
+}
+
+void FUtilityRunner::ScoreActions()
+{
+	const VectorRegister4Float One = VectorOneFloat();
+
+	for (size_t ActionIndex{0}; ActionIndex < Definition->Actions.size(); ++ActionIndex)
+	{
+		const FUtilityAction& Action = Definition->Actions[ActionIndex];
+		float* const Row = &Scores[ActionIndex * Stride];
+		std::fill(Row, Row + Stride, 1.f);
+
+		for (const FConsideration& Consideration : Action.Considerations)
+		{
+			Consideration.Curve.EvaluateBatch(GetInputChannel(Consideration.InputChannel), ConsiderationScratch.data(), Stride);
+			for (int32 i{0}; i < Stride; i += 4)
+			{
+				VectorStore(VectorMultiply(VectorLoad(Row + i), VectorLoad(&ConsiderationScratch[i])), Row + i);
+			}
+		}
+
+		// Multiplying many scores drags actions with more considerations down, give back part of what was lost
+		const float Compensation = Action.Considerations.empty() ? 0.f : 1.f - 1.f / Action.Considerations.size();
+		const VectorRegister4Float CompensationV = VectorSetFloat1(Compensation);
+		const VectorRegister4Float WeightV = VectorSetFloat1(Action.Weight);
+		for (int32 i{0}; i < Stride; i += 4)
+		{
+			const VectorRegister4Float Score = VectorLoad(Row + i);
+			const VectorRegister4Float MakeUp = VectorMultiply(VectorMultiply(VectorSubtract(One, Score), CompensationV), Score);
+			VectorStore(VectorMultiply(VectorAdd(Score, MakeUp), WeightV), Row + i);
+		}
+	}
+
+	const float Inertia = 1.f + Definition->Inertia;
+	for (int32 i{0}; i < NumAgents; ++i)
+	{
+		if (CurrentActions[i] != INDEX_NONE)
+			Scores[CurrentActions[i] * Stride + i] *= Inertia;
+	}
+}
+
+void FUtilityRunner::PickWinners()
+{
+	for (int32 i{0}; i < Stride; i += 4)
+	{
+		VectorRegister4Float BestScore = VectorLoad(&Scores[i]);
+		VectorRegister4Float BestAction = VectorZeroFloat();
+
+		for (size_t ActionIndex{1}; ActionIndex < Definition->Actions.size(); ++ActionIndex)
+		{
+			const VectorRegister4Float Score = VectorLoad(&Scores[ActionIndex * Stride + i]);
+			const VectorRegister4Float IsBetter = VectorCompareGT(Score, BestScore);
+			BestScore = VectorSelect(IsBetter, Score, BestScore);
+			BestAction = VectorSelect(IsBetter, VectorSetFloat1(static_cast<float>(ActionIndex)), BestAction);
+		}
+
+		VectorStore(BestAction, &BestActions[i]);
+	}
+}
+
+void FUtilityRunner::ApplyAction(int32 AgentIndex, int32 ActionIndex)
+{
+	ASteeringAgent* const Agent = Agents[AgentIndex];
+	if (!IsValid(Agent))
+		return;
+
+	const FUtilityAction& Action = Definition->Actions[ActionIndex];
+	switch (Action.Outcome)
+	{
+	case FUtilityAction::EOutcome::SetBehavior:
+		if (ISteeringBehavior* const Behavior = ActionBehaviors[AgentIndex * Definition->Actions.size() + ActionIndex])
+			Agent->SetSteeringBehavior(Behavior);
+		break;
+	case FUtilityAction::EOutcome::SetBlendedWeights:
+		if (BlendedSteering* const Blended = BlendedBehaviors[AgentIndex])
+		{
+			std::vector<BlendedSteering::WeightedBehavior>& WeightedBehaviors = Blended->GetWeightedBehaviorsRef();
+			const size_t NumWeights = FMath::Min(WeightedBehaviors.size(), Action.BlendWeights.size());
+			for (size_t i{0}; i < NumWeights; ++i)
+			{
+				WeightedBehaviors[i].Weight = Action.BlendWeights[i];
+			}
+			Agent->SetSteeringBehavior(Blended);
+		}
+		break;
+	}
+
+	CurrentActions[AgentIndex] = ActionIndex;
+}
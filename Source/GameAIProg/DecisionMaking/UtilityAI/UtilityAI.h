@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <memory>
+#include <vector>
+
+class ASteeringAgent;
+class ISteeringBehavior;
+class BlendedSteering;
+
+// Input channels most steering levels feed, definitions can use more channels than these
+enum class EUtilityInput : int32
+{
+	DistanceToTarget,
+	NeighborCount,
+	Health,
+	Count
+};
+
+/*
+ * Response curve mapping a consideration input to a [0, 1] score.
+ *
+ * The curve is baked into a lookup table on construction, evaluating it is a clamp, a table read and a lerp, four inputs
+ * at a time in EvaluateBatch.
+ */
+class FResponseCurve final
+{
+public:
+	enum class EType : uint8
+	{
+		Linear,     // Slope * (x - XShift) + YShift
+		Polynomial, // Slope * (x - XShift)^Exponent + YShift
+		Logistic    // Slope / (1 + e^(-Exponent * (x - XShift))) + YShift
+	};
+
+	FResponseCurve(EType InType, float InMinInput, float InMaxInput, float Slope = 1.f, float Exponent = 1.f, float XShift = 0.f, float YShift = 0.f);
+
+	float Evaluate(float Input) const;
+	// Count must be a multiple of 4
+	void EvaluateBatch(const float* Inputs, float* OutScores, int32 Count) const;
+
+private:
+	static constexpr int32 TableSize{256};
+
+	float MinInput{0.f};
+	float InputToTable{1.f}; // scales an input in [MinInput, MaxInput] to [0, TableSize - 1]
+	float Table[TableSize + 1]{}; // one extra entry so the lerp never reads out of bounds
+};
+
+struct FConsideration final
+{
+	int32 InputChannel{0};
+	FResponseCurve Curve;
+};
+
+struct FUtilityAction final
+{
+	enum class EOutcome : uint8
+	{
+		SetBehavior,       // switches to the behavior the agent registered for this action
+		SetBlendedWeights  // writes BlendWeights into the agent's BlendedSteering
+	};
+
+	FName Name{};
+	std::vector<FConsideration> Considerations{};
+	float Weight{1.f};
+	EOutcome Outcome{EOutcome::SetBehavior};
+	std::vector<float> BlendWeights{};
+};
+
+// Immutable once shared between runners
+struct FUtilityDefinition final
+{
+	int32 NumInputChannels{0};
+	std::vector<FUtilityAction> Actions{};
+	float Inertia{0.1f}; // bonus given to the action an agent is already executing, avoids flip-flopping
+};
+
+/*
+ * Scores every action for every agent and applies the winners.
+ *
+ * Inputs, scores and results are stored structure-of-arrays with the agent count padded to 4. Scoring runs per action
+ * over all agents at once: every consideration curve is evaluated in one batch and multiplied into the action's score
+ * row, picking the winner is a vectorised max over the rows.
+ */
+class FUtilityRunner final
+{
+public:
+	explicit FUtilityRunner(std::shared_ptr<const FUtilityDefinition> InDefinition);
+
+	int32 AddAgent(ASteeringAgent* Agent, BlendedSteering* Blended = nullptr);
+	void RemoveAgent(ASteeringAgent* Agent); // swaps the last agent into the removed slot
+	int32 FindAgent(const ASteeringAgent* Agent) const;
+	int32 GetNumAgents() const { return NumAgents; }
+
+	// Behavior the agent switches to when ActionIndex wins (SetBehavior outcome), owned by the caller
+	void SetActionBehavior(int32 AgentIndex, int32 ActionIndex, ISteeringBehavior* Behavior);
+
+	void SetInput(int32 AgentIndex, int32 Channel, float Value) { Inputs[Channel * Stride + AgentIndex] = Value; }
+	void SetInput(int32 AgentIndex, EUtilityInput Channel, float Value) { SetInput(AgentIndex, static_cast<int32>(Channel), Value); }
+	float* GetInputChannel(int32 Channel) { return &Inputs[Channel * Stride]; }
+
+	void Update();
+
+	int32 GetCurrentAction(int32 AgentIndex) const { return CurrentActions[AgentIndex]; }
+	float GetScore(int32 AgentIndex, int32 ActionIndex) const { return Scores[ActionIndex * Stride + AgentIndex]; }
+
+private:
+	std::shared_ptr<const FUtilityDefinition> Definition{};
+
+	int32 NumAgents{0};
+	int32 Stride{0}; // NumAgents rounded up to 4
+
+	std::vector<ASteeringAgent*> Agents{}; // non-owning
+	std::vector<BlendedSteering*> BlendedBehaviors{}; // non-owning
+	std::vector<ISteeringBehavior*> ActionBehaviors{}; // NumAgents x NumActions, non-owning
+	std::vector<int32> CurrentActions{};
+
+	std::vector<float> Inputs{}; // NumInputChannels x Stride
+	std::vector<float> Scores{}; // NumActions x Stride
+	std::vector<float> ConsiderationScratch{};
+	std::vector<float> BestActions{};
+
+	void Resize(int32 NewNumAgents);
+	void ScoreActions();
+	void PickWinners();
+	void ApplyAction(int32 AgentIndex, int32 ActionIndex);
+};
@@ -0,0 +1,376 @@
+#include "Formation.h"
+#include "GameAIProg/Movement/SteeringBehaviors/SteeringAgent.h"
+#include "GameAIProg/Shared/SpatialHash.h"
+#include <algorithm>
+
+namespace
+{
+	// Members switch to Arrive inside this distance from their slot and back to Pursuit at twice of it
+	constexpr float ArriveDistance{400.f};
+}
+
+FFormation::FFormation(ASteeringAgent* InLeader, EFormationShape InShape, float InSpacing)
+	: Leader(InLeader)
+	, Shape(InShape)
+	, Spacing(InSpacing)
+{
+}
+
+FFormation::~FFormation()
+{
+	// Agents outlive the formation, they must not keep ticking behaviors owned by it
+	for (const FMember& Member : Members)
+	{
+		DetachBehavior(Member);
+	}
+}
+
+void FFormation::AddMember(ASteeringAgent* Agent)
+{
+	if (!IsValid(Agent) || Agent == Leader)
+		return;
+
+	for (const FMember& Member : Members)
+	{
+		if (Member.Agent == Agent)
+			return;
+	}
+
+	FMember& Member = Members.emplace_back();
+	Member.Agent = Agent;
+	Member.PursueSlot = std::make_unique<Pursuit>();
+	Member.ArriveAtSlot = std::make_unique<Arrive>();
+
+	RebuildSlots();
+}
+
+void FFormation::RemoveMember(ASteeringAgent* Agent)
+{
+	const auto It = std::find_if(Members.begin(), Members.end(), [Agent](const FMember& Member) { return Member.Agent == Agent; });
+	if (It == Members.end())
+		return;
+
+	DetachBehavior(*It);
+
+	*It = std::move(Members.back());
+	Members.pop_back();
+
+	RebuildSlots();
+}
+
+void FFormation::SetShape(EFormationShape NewShape)
+{
+	if (NewShape != Shape)
+	{
+		Shape = NewShape;
+		RebuildSlots();
+	}
+}
+
+void FFormation::SetSpacing(float NewSpacing)
+{
+	if (!FMath::IsNearlyEqual(NewSpacing, Spacing))
+	{
+		Spacing = NewSpacing;
+		RebuildSlots();
+	}
+}
+
+void FFormation::Update()
+{
+	if (!IsValid(Leader))
+		return;
+
+	RemoveInvalidMembers();
+	UpdateLeaderFrame();
+
+	if (bAssignmentDirty)
+		AssignSlots();
+
+	FTargetData Target;
+	Target.Orientation = Leader->GetRotation();
+	Target.LinearVelocity = Leader->GetLinearVelocity();
+
+	for (FMember& Member : Members)
+	{
+		Target.Position = GetSlotPosition(Member.Slot);
+
+		const float DistanceSq = FVector2D::DistSquared(Member.Agent->GetPosition(), Target.Position);
+		if (Member.bArriving && DistanceSq > FMath::Square(2.f * ArriveDistance))
+			Member.bArriving = false;
+		else if (!Member.bArriving && DistanceSq < FMath::Square(ArriveDistance))
+			Member.bArriving = true;
+
+		ISteeringBehavior* const Behavior = Member.bArriving
+			? static_cast<ISteeringBehavior*>(Member.ArriveAtSlot.get())
+			: static_cast<ISteeringBehavior*>(Member.PursueSlot.get());
+
+		Behavior->SetTarget(Target);
+		if (Member.Agent->GetSteeringBehavior() != Behavior)
+			Member.Agent->SetSteeringBehavior(Behavior);
+	}
+}
+
+FVector2D FFormation::GetSlotPosition(int32 Slot) const
+{
+	const FVector2D& Offset = SlotOffsets[Slot];
+	const FVector2D Right{-LeaderForward.Y, LeaderForward.X};
+	return LeaderPosition + LeaderForward * Offset.X + Right * Offset.Y;
+}
+
+void FFormation::DetachBehavior(const FMember& Member)
+{
+	if (!IsValid(Member.Agent))
+		return;
+
+	const ISteeringBehavior* const Behavior = Member.Agent->GetSteeringBehavior();
+	if (Behavior == Member.PursueSlot.get() || Behavior == Member.ArriveAtSlot.get())
+		Member.Agent->SetSteeringBehavior(nullptr);
+}
+
+void FFormation::RemoveInvalidMembers()
+{
+	const auto FirstInvalid = std::remove_if(Members.begin(), Members.end(), [](const FMember& Member) { return !IsValid(Member.Agent); });
+	if (FirstInvalid == Members.end())
+		return;
+
+	Members.erase(FirstInvalid, Members.end());
+	RebuildSlots();
+}
+
+void FFormation::UpdateLeaderFrame()
+{
+	LeaderPosition = Leader->GetPosition();
+
+	// Follow where the leader goes, only fall back to where it looks when it stands still
+	const FVector2D Velocity = Leader->GetLinearVelocity();
+	if (Velocity.SizeSquared() > 100.f)
+	{
+		LeaderForward = Velocity.GetSafeNormal();
+	}
+	else
+	{
+		float Sin, Cos;
+		FMath::SinCos(&Sin, &Cos, FMath::DegreesToRadians(Leader->GetRotation()));
+		LeaderForward = FVector2D{Cos, Sin};
+	}
+}
+
+void FFormation::RebuildSlots()
+{
+	const int32 NumSlots = static_cast<int32>(Members.size());
+	SlotOffsets.resize(NumSlots);
+
+	switch (Shape)
+	{
+	case EFormationShape::Line:
+		for (int32 i{0}; i < NumSlots; ++i)
+		{
+			SlotOffsets[i] = FVector2D{-Spacing, (i - (NumSlots - 1) * 0.5f) * Spacing};
+		}
+		break;
+	case EFormationShape::Wedge:
+		for (int32 i{0}; i < NumSlots; ++i)
+		{
+			const float Row = static_cast<float>(i / 2 + 1);
+			SlotOffsets[i] = FVector2D{-Row * Spacing, (i % 2 == 0 ? -Row : Row) * Spacing};
+		}
+		break;
+	case EFormationShape::Circle:
+	{
+		const float Radius = FMath::Max(Spacing, NumSlots * Spacing / UE_TWO_PI);
+		for (int32 i{0}; i < NumSlots; ++i)
+		{
+			float Sin, Cos;
+			FMath::SinCos(&Sin, &Cos, UE_TWO_PI * i / NumSlots);
+			SlotOffsets[i] = FVector2D{Cos, Sin} * Radius;
+		}
+		break;
+	}
+	case EFormationShape::Grid:
+	{
+		const int32 Columns = FMath::Max(FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumSlots))), 1);
+		for (int32 i{0}; i < NumSlots; ++i)
+		{
+			SlotOffsets[i] = FVector2D{-(i / Columns + 1) * Spacing, (i % Columns - (Columns - 1) * 0.5f) * Spacing};
+		}
+		break;
+	}
+	default:
+		assert(false); // Unknown formation shape
+	}
+
+	bAssignmentDirty = true;
+}
+
+void FFormation::AssignSlots()
+{
+	bAssignmentDirty = false;
+
+	std::vector<FVector2D> SlotPositions(SlotOffsets.size());
+	for (int32 Slot{0}; Slot < static_cast<int32>(SlotOffsets.size()); ++Slot)
+	{
+		SlotPositions[Slot] = GetSlotPosition(Slot);
+	}
+
+	if (Members.size() <= MaxOptimalAssignment)
+		AssignSlotsOptimal(SlotPositions);
+	else
+		AssignSlotsGreedy(SlotPositions);
+}
+
+void FFormation::AssignSlotsOptimal(const std::vector<FVector2D>& SlotPositions)
+{
+	// Hungarian algorithm with potentials, 1-based: row 0 and column 0 are sentinels
+	const int32 N = static_cast<int32>(Members.size());
+	std::vector<float> Cost(static_cast<size_t>(N) * N);
+	for (int32 Member{0}; Member < N; ++Member)
+	{
+		const FVector2D Position = Members[Member].Agent->GetPosition();
+		for (int32 Slot{0}; Slot < N; ++Slot)
+		{
+			Cost[Member * N + Slot] = FVector2D::Distance(Position, SlotPositions[Slot]);
+		}
+	}
+
+	std::vector<float> U(N + 1, 0.f), V(N + 1, 0.f), MinCost(N + 1);
+	std::vector<int32> SlotOwner(N + 1, 0), Way(N + 1, 0);
+	std::vector<uint8> bUsed(N + 1);
+
+	for (int32 Row{1}; Row <= N; ++Row)
+	{
+		SlotOwner[0] = Row;
+		int32 Column{0};
+		std::fill(MinCost.begin(), MinCost.end(), TNumericLimits<float>::Max());
+		std::fill(bUsed.begin(), bUsed.end(), 0);
+
+		do
+		{
+			bUsed[Column] = 1;
+			const int32 CurrentRow = SlotOwner[Column];
+			float Delta{TNumericLimits<float>::Max()};
+			int32 NextColumn{0};
+
+			for (int32 j{1}; j <= N; ++j)
+			{
+				if (bUsed[j])
+					continue;
+
+				const float Reduced = Cost[(CurrentRow - 1) * N + (j - 1)] - U[CurrentRow] - V[j];
+				if (Reduced < MinCost[j])
+				{
+					MinCost[j] = Reduced;
+					Way[j] = Column;
+				}
+				if (MinCost[j] < Delta)
+				{
+					Delta = MinCost[j];
+					NextColumn = j;
+				}
+			}
+
+			for (int32 j{0}; j <= N; ++j)
+			{
+				if (bUsed[j])
+				{
+					U[SlotOwner[j]] += Delta;
+					V[j] -= Delta;
+				}
+				else
+				{
+					MinCost[j] -= Delta;
+				}
+			}
+			Column = NextColumn;
+		}
+		while (SlotOwner[Column] != 0);
+
+		do
+		{
+			const int32 PreviousColumn = Way[Column];
+			SlotOwner[Column] = SlotOwner[PreviousColumn];
+			Column = PreviousColumn;
+		}
+		while (Column != 0);
+	}
+
+	for (int32 Slot{1}; Slot <= N; ++Slot)
+	{
+		Members[SlotOwner[Slot] - 1].Slot = Slot - 1;
+	}
+}
+
+void FFormation::AssignSlotsGreedy(const std::vector<FVector2D>& SlotPositions)
+{
+	// Candidate pairs are every member with its few nearest slots, closest pairs get served first
+	constexpr int32 CandidatesPerMember{8};
+	const int32 N = static_cast<int32>(Members.size());
+
+	FSpatialHash SlotIndex{Spacing, 1024};
+	SlotIndex.Build(SlotPositions.data(), N);
+
+	float FormationRadius{0.f};
+	for (const FVector2D& Offset : SlotOffsets)
+	{
+		FormationRadius = FMath::Max(FormationRadius, Offset.Size());
+	}
+
+	struct FCandidate
+	{
+		float Distance;
+		int32 Member;
+		int32 Slot;
+	};
+	std::vector<FCandidate> Candidates;
+	Candidates.reserve(static_cast<size_t>(N) * CandidatesPerMember);
+
+	std::vector<FVector2D> MemberPositions(N);
+	for (int32 Member{0}; Member < N; ++Member)
+	{
+		MemberPositions[Member] = Members[Member].Agent->GetPosition();
+
+		int32 Nearest[CandidatesPerMember];
+		const float SearchRadius = FVector2D::Distance(MemberPositions[Member], LeaderPosition) + FormationRadius + Spacing;
+		const int32 NumNearest = SlotIndex.QueryNearest(MemberPositions[Member], CandidatesPerMember, SearchRadius, Nearest);
+		for (int32 i{0}; i < NumNearest; ++i)
+		{
+			Candidates.push_back(FCandidate{FVector2D::Distance(MemberPositions[Member], SlotPositions[Nearest[i]]), Member, Nearest[i]});
+		}
+	}
+
+	std::sort(Candidates.begin(), Candidates.end(), [](const FCandidate& A, const FCandidate& B) { return A.Distance < B.Distance; });
+
+	std::vector<uint8> bMemberAssigned(N, 0);
+	std::vector<uint8> bSlotTaken(N, 0);
+	for (const FCandidate& Candidate : Candidates)
+	{
+		if (bMemberAssigned[Candidate.Member] || bSlotTaken[Candidate.Slot])
+			continue;
+
+		Members[Candidate.Member].Slot = Candidate.Slot;
+		bMemberAssigned[Candidate.Member] = 1;
+		bSlotTaken[Candidate.Slot] = 1;
+	}
+
+	// Whoever lost all of its candidates takes the closest slot still free
+	for (int32 Member{0}; Member < N; ++Member)
+	{
+		if (bMemberAssigned[Member])
+			continue;
+
+		int32 BestSlot{INDEX_NONE};
+		float BestDistanceSq{TNumericLimits<float>::Max()};
+		for (int32 Slot{0}; Slot < N; ++Slot)
+		{
+			const float DistanceSq = FVector2D::DistSquared(MemberPositions[Member], SlotPositions[Slot]);
+			if (!bSlotTaken[Slot] && DistanceSq < BestDistanceSq)
+			{
+				BestDistanceSq = DistanceSq;
+				BestSlot = Slot;
+			}
+		}
+
+		Members[Member].Slot = BestSlot;
+		bSlotTaken[BestSlot] = 1;
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameAIProg/Movement/SteeringBehaviors/Steering/SteeringBehaviors.h"
+#include <memory>
+#include <vector>
+
+class ASteeringAgent;
+
+enum class EFormationShape : uint8
+{
+	Line,
+	Wedge,
+	Circle,
+	Grid,
+
+	// @ End
+	Count
+};
+
+/*
+ * A group of agents keeping formation around a leader.
+ *
+ * Slots are offsets in the leader's frame (X along its heading), every member steers to its slot with Pursuit while far
+ * away and Arrive once close. Which member takes which slot is only solved when members join or leave, or when the shape
+ * or spacing changes: optimally (Hungarian) for small groups, greedily over the nearest free slots for large ones.
+ */
+class FFormation final
+{
+public:
+	explicit FFormation(ASteeringAgent* InLeader, EFormationShape InShape = EFormationShape::Wedge, float InSpacing = 150.f);
+	~FFormation(); // members are left without a steering behavior
+
+	void AddMember(ASteeringAgent* Agent);
+	void RemoveMember(ASteeringAgent* Agent); // the member is left without a steering behavior
+	int32 GetNumMembers() const { return static_cast<int32>(Members.size()); }
+
+	void SetLeader(ASteeringAgent* NewLeader) { Leader = NewLeader; }
+	void SetShape(EFormationShape NewShape);
+	EFormationShape GetShape() const { return Shape; }
+	void SetSpacing(float NewSpacing);
+	float GetSpacing() const { return Spacing; }
+
+	void Update(); // members whose agent was destroyed leave the formation
+
+	FVector2D GetSlotPosition(int32 Slot) const;
+	int32 GetMemberSlot(int32 Member) const { return Members[Member].Slot; }
+
+private:
+	static constexpr int32 MaxOptimalAssignment{64}; // Hungarian is O(n^3), above this size assignment is greedy
+
+	struct FMember
+	{
+		ASteeringAgent* Agent{nullptr}; // non-owning
+		int32 Slot{0};
+		bool bArriving{false};
+		std::unique_ptr<Pursuit> PursueSlot{};
+		std::unique_ptr<Arrive> ArriveAtSlot{};
+	};
+
+	ASteeringAgent* Leader{nullptr}; // non-owning
+	EFormationShape Shape{EFormationShape::Wedge};
+	float Spacing{150.f};
+
+	std::vector<FMember> Members{};
+	std::vector<FVector2D> SlotOffsets{};
+	bool bAssignmentDirty{true};
+
+	FVector2D LeaderPosition{FVector2D::ZeroVector};
+	FVector2D LeaderForward{1.f, 0.f};
+
+	static void DetachBehavior(const FMember& Member);
+	void RemoveInvalidMembers();
+	void UpdateLeaderFrame();
+	void RebuildSlots();
+	void AssignSlots();
+	void AssignSlotsOptimal(const std::vector<FVector2D>& SlotPositions);
+	void AssignSlotsGreedy(const std::vector<FVector2D>& SlotPositions);
+};
@@ -0,0 +1,484 @@
+#include "HierarchicalPathfinder.h"
+#include <algorithm>
+#include <functional>
+#include "DrawDebugHelpers.h"
+
+//*******************
+//HIERARCHICAL PATH
+void FHierarchicalPath::Reset()
+{
+	Pathfinder = nullptr;
+	AbstractCells.clear();
+	SegmentVersions.clear();
+	RefinedCells.clear();
+	NextAbstract = 0;
+	NextRefined = 0;
+}
+
+bool FHierarchicalPath::GetCurrentWaypoint(FVector2D& OutWaypoint)
+{
+	if (!IsValid())
+		return false;
+
+	while (NextRefined >= RefinedCells.size())
+	{
+		if (!RefineNextSegment())
+			return false;
+	}
+
+	OutWaypoint = Pathfinder->GetGrid().CellToWorld(RefinedCells[NextRefined]);
+	return true;
+}
+
+bool FHierarchicalPath::IsLastWaypoint() const
+{
+	return NextAbstract >= AbstractCells.size() && NextRefined + 1 >= RefinedCells.size();
+}
+
+void FHierarchicalPath::AdvanceWaypoint()
+{
+	if (NextRefined < RefinedCells.size())
+		++NextRefined;
+}
+
+bool FHierarchicalPath::RefineNextSegment()
+{
+	if (NextAbstract >= AbstractCells.size())
+	{
+		Reset();
+		return false;
+	}
+
+	// The first abstract cell is the start itself
+	if (NextAbstract == 0)
+	{
+		RefinedCells.assign(1, AbstractCells[0]);
+		NextRefined = 0;
+		NextAbstract = 1;
+		return true;
+	}
+
+	const FIntPoint From = AbstractCells[NextAbstract - 1];
+	const FIntPoint To = AbstractCells[NextAbstract];
+
+	const int32 ClusterIndex = Pathfinder->GetClusterIndex(From);
+	const bool bIsStale = ClusterIndex == Pathfinder->GetClusterIndex(To)
+		&& Pathfinder->GetClusterVersion(ClusterIndex) != SegmentVersions[NextAbstract];
+
+	if (bIsStale || !Pathfinder->RefineSegment(From, To, RefinedCells))
+	{
+		// The world changed under us, plan again from where we are
+		FHierarchicalPathfinder* const Owner = Pathfinder;
+		const FVector2D FinalGoal = Goal;
+		return Owner->FindPath(Owner->GetGrid().CellToWorld(From), FinalGoal, *this);
+	}
+
+	// Skip the first cell, it was the last waypoint of the previous segment
+	NextRefined = RefinedCells.size() > 1 ? 1 : 0;
+	++NextAbstract;
+	return true;
+}
+
+//*************************
+//HIERARCHICAL PATHFINDER
+FHierarchicalPathfinder::FHierarchicalPathfinder(FPathGrid& InGrid, int32 InClusterSize)
+	: Grid(InGrid)
+	, ClusterSize(FMath::Max(InClusterSize, 2))
+{
+	Rebuild();
+}
+
+int32 FHierarchicalPathfinder::GetClusterIndex(const FIntPoint& Cell) const
+{
+	return (Cell.Y / ClusterSize) * ClustersX + (Cell.X / ClusterSize);
+}
+
+void FHierarchicalPathfinder::Rebuild()
+{
+	ClustersX = FMath::DivideAndRoundUp(Grid.GetWidth(), ClusterSize);
+	ClustersY = FMath::DivideAndRoundUp(Grid.GetHeight(), ClusterSize);
+
+	Clusters.assign(static_cast<size_t>(ClustersX) * ClustersY, FCluster{});
+	Nodes.clear();
+	FreeNodes.clear();
+	BorderNodes.assign(Clusters.size() * static_cast<size_t>(EBorder::Count), {});
+	DirtyBorders.assign(BorderNodes.size(), 1);
+
+	for (int32 Cy{0}; Cy < ClustersY; ++Cy)
+	{
+		for (int32 Cx{0}; Cx < ClustersX; ++Cx)
+		{
+			FCluster& Cluster = Clusters[Cy * ClustersX + Cx];
+			Cluster.Bounds.Min = FIntPoint{Cx * ClusterSize, Cy * ClusterSize};
+			Cluster.Bounds.Max = FIntPoint{
+				FMath::Min(Cluster.Bounds.Min.X + ClusterSize, Grid.GetWidth()),
+				FMath::Min(Cluster.Bounds.Min.Y + ClusterSize, Grid.GetHeight())
+			};
+		}
+	}
+
+	bHasDirtyClusters = true;
+	UpdateDirtyClusters();
+}
+
+void FHierarchicalPathfinder::SetWalkable(const FIntPoint& Cell, bool bWalkable)
+{
+	if (!Grid.IsInBounds(Cell) || Grid.IsWalkable(Cell) == bWalkable)
+		return;
+
+	Grid.SetWalkable(Cell, bWalkable);
+	MarkCellDirty(Cell);
+}
+
+void FHierarchicalPathfinder::MarkCellDirty(const FIntPoint& Cell)
+{
+	const int32 ClusterIndex = GetClusterIndex(Cell);
+	FCluster& Cluster = Clusters[ClusterIndex];
+	++Cluster.Version;
+	Cluster.bDistancesDirty = true;
+	bHasDirtyClusters = true;
+
+	// Cells on a cluster edge also change the entrances of that border
+	const FIntPoint Local = Cell - Cluster.Bounds.Min;
+	if (Local.X == Cluster.Bounds.Width() - 1)
+		DirtyBorders[GetBorderIndex(ClusterIndex, EBorder::East)] = 1;
+	if (Local.X == 0 && Cluster.Bounds.Min.X > 0)
+		DirtyBorders[GetBorderIndex(ClusterIndex - 1, EBorder::East)] = 1;
+	if (Local.Y == Cluster.Bounds.Height() - 1)
+		DirtyBorders[GetBorderIndex(ClusterIndex, EBorder::North)] = 1;
+	if (Local.Y == 0 && Cluster.Bounds.Min.Y > 0)
+		DirtyBorders[GetBorderIndex(ClusterIndex - ClustersX, EBorder::North)] = 1;
+}
+
+void FHierarchicalPathfinder::UpdateDirtyClusters()
+{
+	if (!bHasDirtyClusters)
+		return;
+
+	for (int32 ClusterIndex{0}; ClusterIndex < static_cast<int32>(Clusters.size()); ++ClusterIndex)
+	{
+		for (int32 Border{0}; Border < static_cast<int32>(EBorder::Count); ++Border)
+		{
+			uint8& bIsDirty = DirtyBorders[GetBorderIndex(ClusterIndex, static_cast<EBorder>(Border))];
+			if (bIsDirty)
+			{
+				RebuildBorder(ClusterIndex, static_cast<EBorder>(Border));
+				bIsDirty = 0;
+			}
+		}
+	}
+
+	for (FCluster& Cluster : Clusters)
+	{
+		if (Cluster.bDistancesDirty)
+			RebuildClusterDistances(Cluster);
+	}
+
+	bHasDirtyClusters = false;
+}
+
+int32 FHierarchicalPathfinder::AllocateNode(const FIntPoint& Cell, int32 Cluster)
+{
+	int32 NodeIndex;
+	if (!FreeNodes.empty())
+	{
+		NodeIndex = FreeNodes.back();
+		FreeNodes.pop_back();
+	}
+	else
+	{
+		NodeIndex = static_cast<int32>(Nodes.size());
+		Nodes.emplace_back();
+	}
+
+	FPortalNode& Node = Nodes[NodeIndex];
+	Node.Cell = Cell;
+	Node.Cluster = Cluster;
+	Node.LinkedNode = INDEX_NONE;
+	Node.bInUse = true;
+
+	FCluster& Owner = Clusters[Cluster];
+	Node.LocalIndex = static_cast<int32>(Owner.Nodes.size());
+	Owner.Nodes.push_back(NodeIndex);
+	Owner.bDistancesDirty = true;
+
+	return NodeIndex;
+}
+
+void FHierarchicalPathfinder::RebuildBorder(int32 ClusterIndex, EBorder Border)
+{
+	const int32 Cx = ClusterIndex % ClustersX;
+	const int32 Cy = ClusterIndex / ClustersX;
+	const bool bIsEast = Border == EBorder::East;
+
+	// Drop the portals this border had
+	std::vector<int32>& Portals = BorderNodes[GetBorderIndex(ClusterIndex, Border)];
+	for (int32 NodeIndex : Portals)
+	{
+		FPortalNode& Node = Nodes[NodeIndex];
+		FCluster& Owner = Clusters[Node.Cluster];
+		Owner.Nodes.erase(std::remove(Owner.Nodes.begin(), Owner.Nodes.end(), NodeIndex), Owner.Nodes.end());
+		Owner.bDistancesDirty = true;
+
+		Node.bInUse = false;
+		FreeNodes.push_back(NodeIndex);
+	}
+	Portals.clear();
+
+	if ((bIsEast && Cx + 1 >= ClustersX) || (!bIsEast && Cy + 1 >= ClustersY))
+		return;
+
+	const int32 NeighborIndex = bIsEast ? ClusterIndex + 1 : ClusterIndex + ClustersX;
+	const FIntRect& Bounds = Clusters[ClusterIndex].Bounds;
+	const FIntPoint Step = bIsEast ? FIntPoint{0, 1} : FIntPoint{1, 0};
+	const FIntPoint Across = bIsEast ? FIntPoint{1, 0} : FIntPoint{0, 1};
+	const FIntPoint First = bIsEast ? FIntPoint{Bounds.Max.X - 1, Bounds.Min.Y} : FIntPoint{Bounds.Min.X, Bounds.Max.Y - 1};
+	const int32 Length = bIsEast ? Bounds.Height() : Bounds.Width();
+
+	auto AddPortalPair = [&](int32 Offset)
+	{
+		const FIntPoint Cell = First + Step * Offset;
+		const int32 Inside = AllocateNode(Cell, ClusterIndex);
+		const int32 Outside = AllocateNode(Cell + Across, NeighborIndex);
+		Nodes[Inside].LinkedNode = Outside;
+		Nodes[Outside].LinkedNode = Inside;
+		Portals.push_back(Inside);
+		Portals.push_back(Outside);
+	};
+
+	// Walk the border, every maximal run of cells that are open on both sides is an entrance
+	int32 RunStart = INDEX_NONE;
+	for (int32 Offset{0}; Offset <= Length; ++Offset)
+	{
+		const FIntPoint Cell = First + Step * Offset;
+		const bool bIsOpen = Offset < Length && Grid.IsWalkable(Cell) && Grid.IsWalkable(Cell + Across);
+
+		if (bIsOpen && RunStart == INDEX_NONE)
+		{
+			RunStart = Offset;
+		}
+		else if (!bIsOpen && RunStart != INDEX_NONE)
+		{
+			const int32 RunLength = Offset - RunStart;
+			if (RunLength < MaxSingleEntranceWidth)
+			{
+				AddPortalPair(RunStart + RunLength / 2);
+			}
+			else
+			{
+				AddPortalPair(RunStart);
+				AddPortalPair(Offset - 1);
+			}
+			RunStart = INDEX_NONE;
+		}
+	}
+}
+
+void FHierarchicalPathfinder::RebuildClusterDistances(FCluster& Cluster)
+{
+	const size_t NumNodes = Cluster.Nodes.size();
+	Cluster.Distances.assign(NumNodes * NumNodes, MAX_flt);
+
+	for (size_t i{0}; i < NumNodes; ++i)
+	{
+		Nodes[Cluster.Nodes[i]].LocalIndex = static_cast<int32>(i);
+	}
+
+	for (size_t i{0}; i < NumNodes; ++i)
+	{
+		Grid.ComputeCostField(Nodes[Cluster.Nodes[i]].Cell, Cluster.Bounds, CostField);
+
+		for (size_t j{0}; j < NumNodes; ++j)
+		{
+			const FIntPoint Local = Nodes[Cluster.Nodes[j]].Cell - Cluster.Bounds.Min;
+			Cluster.Distances[i * NumNodes + j] = CostField[Local.Y * Cluster.Bounds.Width() + Local.X];
+		}
+	}
+
+	Cluster.bDistancesDirty = false;
+}
+
+void FHierarchicalPathfinder::GatherPortalDistances(const FIntPoint& From, const FCluster& Cluster, std::vector<float>& OutDistances)
+{
+	Grid.ComputeCostField(From, Cluster.Bounds, CostField);
+
+	OutDistances.resize(Cluster.Nodes.size());
+	for (size_t i{0}; i < Cluster.Nodes.size(); ++i)
+	{
+		const FIntPoint Local = Nodes[Cluster.Nodes[i]].Cell - Cluster.Bounds.Min;
+		OutDistances[i] = CostField[Local.Y * Cluster.Bounds.Width() + Local.X];
+	}
+}
+
+bool FHierarchicalPathfinder::FindPath(const FVector2D& Start, const FVector2D& Goal, FHierarchicalPath& OutPath)
+{
+	OutPath.Reset();
+
+	const FIntPoint StartCell = Grid.WorldToCell(Start);
+	const FIntPoint GoalCell = Grid.WorldToCell(Goal);
+	if (!Grid.IsWalkable(StartCell) || !Grid.IsWalkable(GoalCell))
+		return false;
+
+	UpdateDirtyClusters();
+
+	const int32 StartCluster = GetClusterIndex(StartCell);
+	const int32 GoalCluster = GetClusterIndex(GoalCell);
+
+	// Same cluster and connected inside of it: no need for the abstract graph, the grid path is the refined path
+	std::vector<FIntPoint> Abstract{};
+	const bool bIsRefined = StartCluster == GoalCluster
+		&& Grid.FindPath(StartCell, GoalCell, Clusters[StartCluster].Bounds, OutPath.RefinedCells);
+	if (bIsRefined)
+	{
+		Abstract = {StartCell, GoalCell};
+	}
+	else if (!SearchAbstractGraph(StartCell, GoalCell, Abstract))
+	{
+		OutPath.Reset();
+		return false;
+	}
+
+	OutPath.Pathfinder = this;
+	OutPath.Goal = Goal;
+	OutPath.AbstractCells = std::move(Abstract);
+	if (!bIsRefined)
+		OutPath.RefinedCells.clear();
+	OutPath.NextAbstract = bIsRefined ? OutPath.AbstractCells.size() : 0; // nothing left to refine lazily
+	OutPath.NextRefined = 0;
+
+	OutPath.SegmentVersions.resize(OutPath.AbstractCells.size());
+	for (size_t i{0}; i < OutPath.AbstractCells.size(); ++i)
+	{
+		OutPath.SegmentVersions[i] = Clusters[GetClusterIndex(OutPath.AbstractCells[i])].Version;
+	}
+
+	return true;
+}
+
+bool FHierarchicalPathfinder::SearchAbstractGraph(const FIntPoint& StartCell, const FIntPoint& GoalCell, std::vector<FIntPoint>& OutCells)
+{
+	const FCluster& StartCluster = Clusters[GetClusterIndex(StartCell)];
+	const FCluster& GoalCluster = Clusters[GetClusterIndex(GoalCell)];
+	GatherPortalDistances(StartCell, StartCluster, StartDistances);
+	GatherPortalDistances(GoalCell, GoalCluster, GoalDistances);
+
+	// Start and goal are temporary nodes appended after the portals
+	const int32 StartNode = static_cast<int32>(Nodes.size());
+	const int32 GoalNode = StartNode + 1;
+	const size_t NumSearchNodes = Nodes.size() + 2;
+
+	SearchCosts.assign(NumSearchNodes, MAX_flt);
+	SearchParents.assign(NumSearchNodes, INDEX_NONE);
+	SearchClosed.assign(NumSearchNodes, 0);
+	SearchOpen.clear();
+
+	auto CellOf = [&](int32 Node) { return Node == StartNode ? StartCell : Node == GoalNode ? GoalCell : Nodes[Node].Cell; };
+	auto Relax = [&](int32 From, int32 To, float EdgeCost)
+	{
+		const float NewCost = SearchCosts[From] + EdgeCost;
+		if (SearchClosed[To] || NewCost >= SearchCosts[To])
+			return;
+
+		SearchCosts[To] = NewCost;
+		SearchParents[To] = From;
+		SearchOpen.push_back({NewCost + FPathGrid::OctileDistance(CellOf(To), GoalCell), To});
+		std::push_heap(SearchOpen.begin(), SearchOpen.end(), std::greater<>{});
+	};
+
+	SearchCosts[StartNode] = 0.f;
+	SearchOpen.push_back({FPathGrid::OctileDistance(StartCell, GoalCell), StartNode});
+
+	while (!SearchOpen.empty())
+	{
+		std::pop_heap(SearchOpen.begin(), SearchOpen.end(), std::greater<>{});
+		const int32 Current = SearchOpen.back().Node;
+		SearchOpen.pop_back();
+
+		if (SearchClosed[Current])
+			continue;
+		SearchClosed[Current] = 1;
+
+		if (Current == GoalNode)
+			break;
+
+		if (Current == StartNode)
+		{
+			for (size_t i{0}; i < StartCluster.Nodes.size(); ++i)
+			{
+				if (StartDistances[i] < MAX_flt)
+					Relax(Current, StartCluster.Nodes[i], StartDistances[i]);
+			}
+			continue;
+		}
+
+		const FPortalNode& Node = Nodes[Current];
+		const FCluster& Cluster = Clusters[Node.Cluster];
+		const size_t NumClusterNodes = Cluster.Nodes.size();
+
+		// Inter-cluster edge
+		if (Node.LinkedNode != INDEX_NONE)
+			Relax(Current, Node.LinkedNode, 1.f);
+
+		// Intra-cluster edges, precomputed
+		for (size_t j{0}; j < NumClusterNodes; ++j)
+		{
+			const float Distance = Cluster.Distances[Node.LocalIndex * NumClusterNodes + j];
+			if (static_cast<int32>(j) != Node.LocalIndex && Distance < MAX_flt)
+				Relax(Current, Cluster.Nodes[j], Distance);
+		}
+
+		if (&Cluster == &GoalCluster && GoalDistances[Node.LocalIndex] < MAX_flt)
+			Relax(Current, GoalNode, GoalDistances[Node.LocalIndex]);
+	}
+
+	OutCells.clear();
+	if (!SearchClosed[GoalNode])
+		return false;
+
+	for (int32 Node = GoalNode; Node != INDEX_NONE; Node = SearchParents[Node])
+	{
+		OutCells.push_back(CellOf(Node));
+	}
+	std::reverse(OutCells.begin(), OutCells.end());
+
+	return true;
+}
+
+bool FHierarchicalPathfinder::RefineSegment(const FIntPoint& From, const FIntPoint& To, std::vector<FIntPoint>& OutCells) const
+{
+	const int32 FromCluster = GetClusterIndex(From);
+	if (FromCluster == GetClusterIndex(To))
+		return Grid.FindPath(From, To, Clusters[FromCluster].Bounds, OutCells);
+
+	// Crossing a border between two portals, a single step
+	OutCells.clear();
+	if (!Grid.IsWalkable(From) || !Grid.IsWalkable(To))
+		return false;
+
+	OutCells.push_back(From);
+	OutCells.push_back(To);
+	return true;
+}
+
+void FHierarchicalPathfinder::DebugDraw(const UWorld* World, float Height) const
+{
+	const float CellSize = Grid.GetCellSize();
+	for (const FCluster& Cluster : Clusters)
+	{
+		const FVector2D Min = Grid.GetOrigin() + FVector2D{Cluster.Bounds.Min} * CellSize;
+		const FVector2D Extent = FVector2D{Cluster.Bounds.Size()} * CellSize * 0.5f;
+		DrawDebugBox(World, FVector{Min + Extent, Height}, FVector{Extent, 0.f}, FColor::Silver);
+	}
+
+	for (const FPortalNode& Node : Nodes)
+	{
+		if (!Node.bInUse)
+			continue;
+
+		const FVector Position{Grid.CellToWorld(Node.Cell), Height};
+		DrawDebugPoint(World, Position, 8.f, FColor::Yellow);
+
+		if (Node.LinkedNode != INDEX_NONE)
+			DrawDebugLine(World, Position, FVector{Grid.CellToWorld(Nodes[Node.LinkedNode].Cell), Height}, FColor::Orange);
+	}
+}
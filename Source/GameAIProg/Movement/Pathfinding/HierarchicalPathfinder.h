@@ -0,0 +1,145 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PathGrid.h"
+#include <vector>
+
+class FHierarchicalPathfinder;
+
+/*
+ * Result of a hierarchical query.
+ *
+ * Only the abstract path (start, portals, goal) is computed up front. Each abstract segment stays inside one cluster
+ * (or steps over a cluster border), and is refined into grid cells the moment the agent reaches it.
+ * Segments whose cluster was edited after planning trigger a re-plan from the current position.
+ */
+class FHierarchicalPath final
+{
+public:
+	FHierarchicalPath() = default;
+
+	bool IsValid() const { return Pathfinder != nullptr && !AbstractCells.empty(); }
+	void Reset();
+
+	// Current waypoint in world space, refines the next abstract segment when needed. Returns false when the path is done or broken.
+	bool GetCurrentWaypoint(FVector2D& OutWaypoint);
+	bool IsLastWaypoint() const;
+	void AdvanceWaypoint();
+
+	const FVector2D& GetGoal() const { return Goal; }
+	const std::vector<FIntPoint>& GetAbstractCells() const { return AbstractCells; }
+
+private:
+	friend class FHierarchicalPathfinder;
+
+	FHierarchicalPathfinder* Pathfinder{nullptr}; // non-owning
+	FVector2D Goal{FVector2D::ZeroVector};
+
+	std::vector<FIntPoint> AbstractCells{};
+	std::vector<uint32> SegmentVersions{}; // cluster version of segment i (AbstractCells[i - 1] -> AbstractCells[i]) at plan time
+	size_t NextAbstract{0};
+
+	std::vector<FIntPoint> RefinedCells{};
+	size_t NextRefined{0};
+
+	bool RefineNextSegment();
+};
+
+/*
+ * HPA* on top of an FPathGrid.
+ *
+ * The grid is split in square clusters. Along every shared cluster border the walkable runs become entrances, each with
+ * one or two portal node pairs. Per cluster, the distances between all of its portals are precomputed, so the abstract
+ * graph can be searched without touching the grid. Grid edits only flag the clusters (and borders) they touch, which get
+ * rebuilt lazily before the next query.
+ */
+class FHierarchicalPathfinder final
+{
+public:
+	explicit FHierarchicalPathfinder(FPathGrid& InGrid, int32 InClusterSize = 10);
+
+	void Rebuild();
+	void UpdateDirtyClusters();
+
+	// Preferred way to edit the grid, keeps the abstraction in sync
+	void SetWalkable(const FIntPoint& Cell, bool bWalkable);
+
+	bool FindPath(const FVector2D& Start, const FVector2D& Goal, FHierarchicalPath& OutPath);
+	bool RefineSegment(const FIntPoint& From, const FIntPoint& To, std::vector<FIntPoint>& OutCells) const;
+
+	const FPathGrid& GetGrid() const { return Grid; }
+	int32 GetClusterIndex(const FIntPoint& Cell) const;
+	uint32 GetClusterVersion(int32 ClusterIndex) const { return Clusters[ClusterIndex].Version; }
+
+	void DebugDraw(const UWorld* World, float Height = 1.f) const;
+
+private:
+	struct FPortalNode
+	{
+		FIntPoint Cell{};
+		int32 Cluster{INDEX_NONE};
+		int32 LocalIndex{INDEX_NONE}; // index in the cluster's Nodes list
+		int32 LinkedNode{INDEX_NONE}; // portal on the other side of the border
+		bool bInUse{false};
+	};
+
+	struct FCluster
+	{
+		FIntRect Bounds{};
+		std::vector<int32> Nodes{};
+		std::vector<float> Distances{}; // Nodes.size() x Nodes.size(), MAX_flt if not connected inside the cluster
+		uint32 Version{0};
+		bool bDistancesDirty{true};
+	};
+
+	enum class EBorder : uint8
+	{
+		East,
+		North,
+
+		// @ End
+		Count
+	};
+
+	struct FSearchEntry
+	{
+		float Cost;
+		int32 Node;
+
+		bool operator>(const FSearchEntry& Other) const { return Cost > Other.Cost; }
+	};
+
+	// Entrances shorter than this get one portal in the middle, longer ones get one at each end
+	static constexpr int32 MaxSingleEntranceWidth{6};
+
+	FPathGrid& Grid;
+	int32 ClusterSize{10};
+	int32 ClustersX{0};
+	int32 ClustersY{0};
+
+	std::vector<FCluster> Clusters{};
+	std::vector<FPortalNode> Nodes{};
+	std::vector<int32> FreeNodes{};
+	std::vector<std::vector<int32>> BorderNodes{}; // indexed by GetBorderIndex
+	std::vector<uint8> DirtyBorders{};
+	bool bHasDirtyClusters{false};
+
+	// Query scratch
+	std::vector<float> CostField{};
+	std::vector<float> StartDistances{};
+	std::vector<float> GoalDistances{};
+	std::vector<float> SearchCosts{};
+	std::vector<int32> SearchParents{};
+	std::vector<uint8> SearchClosed{};
+	std::vector<FSearchEntry> SearchOpen{};
+
+	int32 GetBorderIndex(int32 ClusterIndex, EBorder Border) const { return ClusterIndex * static_cast<int32>(EBorder::Count) + static_cast<int32>(Border); }
+
+	int32 AllocateNode(const FIntPoint& Cell, int32 Cluster);
+	void RebuildBorder(int32 ClusterIndex, EBorder Border);
+	void RebuildClusterDistances(FCluster& Cluster);
+	void GatherPortalDistances(const FIntPoint& From, const FCluster& Cluster, std::vector<float>& OutDistances);
+	void MarkCellDirty(const FIntPoint& Cell);
+
+	bool SearchAbstractGraph(const FIntPoint& StartCell, const FIntPoint& GoalCell, std::vector<FIntPoint>& OutCells);
+};
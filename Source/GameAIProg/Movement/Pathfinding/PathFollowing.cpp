@@ -0,0 +1,38 @@
+#include "PathFollowing.h"
+#include "GameAIProg/Movement/SteeringBehaviors/SteeringAgent.h"
+
+// FOLLOW PATH
+SteeringOutput FollowPath::CalculateSteering(float DeltaT, ASteeringAgent& Agent)
+{
+    FVector2D Waypoint;
+    const FVector2D AgentPos = Agent.GetPosition();
+
+    // Skip every waypoint we already reached, this is what drives the lazy refinement of the path
+    while (Path.GetCurrentWaypoint(Waypoint) && !Path.IsLastWaypoint()
+        && FVector2D::DistSquared(AgentPos, Waypoint) < m_WaypointRadius * m_WaypointRadius)
+    {
+        Path.AdvanceWaypoint();
+    }
+
+    if (!Path.GetCurrentWaypoint(Waypoint)
+        || (Path.IsLastWaypoint() && FVector2D::DistSquared(AgentPos, Path.GetGoal()) < m_GoalRadius * m_GoalRadius))
+    {
+        Path.Reset();
+
+        SteeringOutput Steering{};
+        Steering.IsValid = false;
+        return Steering;
+    }
+
+    // Head for the exact goal position on the last cell instead of the cell center
+    FTargetData WaypointTarget;
+    WaypointTarget.Position = Path.IsLastWaypoint() ? Path.GetGoal() : Waypoint;
+    SetTarget(WaypointTarget);
+
+    if (Agent.GetDebugRenderingEnabled())
+    {
+        DrawDebugLine(Agent.GetWorld(), FVector(AgentPos, 0), FVector(WaypointTarget.Position, 0), FColor::Yellow, false, -1.f, 0, 2.f);
+    }
+
+    return Seek::CalculateSteering(DeltaT, Agent);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "HierarchicalPathfinder.h"
+#include "GameAIProg/Movement/SteeringBehaviors/Steering/SteeringBehaviors.h"
+
+// FollowPath - seeks the current waypoint of a hierarchical path, the path refines itself lazily as the agent advances
+class FollowPath : public Seek
+{
+public:
+	FollowPath() = default;
+	virtual ~FollowPath() = default;
+
+	virtual SteeringOutput CalculateSteering(float DeltaT, ASteeringAgent& Agent) override;
+
+	void SetPath(FHierarchicalPath&& NewPath) { Path = std::move(NewPath); }
+	FHierarchicalPath& GetPath() { return Path; }
+	bool HasPath() const { return Path.IsValid(); }
+
+	void SetWaypointRadius(float radius) { m_WaypointRadius = radius; }
+	void SetGoalRadius(float radius) { m_GoalRadius = radius; }
+
+protected:
+	FHierarchicalPath Path{};
+	float m_WaypointRadius = 40.f;
+	float m_GoalRadius = 20.f;
+};
@@ -0,0 +1,169 @@
+#include "PathGrid.h"
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+	constexpr float DiagonalCost = 1.41421356f;
+
+	const FIntPoint NeighborOffsets[8] = {
+		{1, 0}, {-1, 0}, {0, 1}, {0, -1},
+		{1, 1}, {1, -1}, {-1, 1}, {-1, -1}
+	};
+}
+
+FPathGrid::FPathGrid(int32 InWidth, int32 InHeight, float InCellSize, const FVector2D& InOrigin)
+	: Width(InWidth)
+	, Height(InHeight)
+	, CellSize(InCellSize)
+	, Origin(InOrigin)
+	, Walkable(static_cast<size_t>(InWidth) * InHeight, 1)
+{
+}
+
+void FPathGrid::SetWalkable(const FIntPoint& Cell, bool bWalkable)
+{
+	if (IsInBounds(Cell))
+	{
+		Walkable[ToIndex(Cell)] = bWalkable ? 1 : 0;
+	}
+}
+
+FIntPoint FPathGrid::WorldToCell(const FVector2D& WorldPos) const
+{
+	const FVector2D Local = (WorldPos - Origin) / CellSize;
+	return FIntPoint{FMath::FloorToInt(Local.X), FMath::FloorToInt(Local.Y)};
+}
+
+FVector2D FPathGrid::CellToWorld(const FIntPoint& Cell) const
+{
+	return Origin + FVector2D{Cell.X + 0.5f, Cell.Y + 0.5f} * CellSize;
+}
+
+float FPathGrid::OctileDistance(const FIntPoint& A, const FIntPoint& B)
+{
+	const int32 Dx = FMath::Abs(A.X - B.X);
+	const int32 Dy = FMath::Abs(A.Y - B.Y);
+	return static_cast<float>(Dx + Dy) + (DiagonalCost - 2.f) * FMath::Min(Dx, Dy);
+}
+
+template<typename FVisitor>
+void FPathGrid::ForEachNeighbor(const FIntPoint& Cell, const FIntRect& Bounds, FVisitor&& Visit) const
+{
+	for (int i{0}; i < 8; ++i)
+	{
+		const FIntPoint& Offset = NeighborOffsets[i];
+		const FIntPoint Neighbor = Cell + Offset;
+		if (!Bounds.Contains(Neighbor) || !IsWalkable(Neighbor))
+			continue;
+
+		const bool bIsDiagonal = Offset.X != 0 && Offset.Y != 0;
+		if (bIsDiagonal && (!IsWalkable(FIntPoint{Cell.X + Offset.X, Cell.Y}) || !IsWalkable(FIntPoint{Cell.X, Cell.Y + Offset.Y})))
+			continue;
+
+		Visit(Neighbor, bIsDiagonal ? DiagonalCost : 1.f);
+	}
+}
+
+bool FPathGrid::FindPath(const FIntPoint& From, const FIntPoint& To, const FIntRect& Bounds, std::vector<FIntPoint>& OutCells) const
+{
+	OutCells.clear();
+	if (!Bounds.Contains(From) || !Bounds.Contains(To) || !IsWalkable(From) || !IsWalkable(To))
+		return false;
+
+	const int32 LocalWidth = Bounds.Width();
+	const size_t NumLocal = static_cast<size_t>(LocalWidth) * Bounds.Height();
+	auto ToLocal = [&Bounds, LocalWidth](const FIntPoint& Cell) { return (Cell.Y - Bounds.Min.Y) * LocalWidth + (Cell.X - Bounds.Min.X); };
+	auto ToCell = [&Bounds, LocalWidth](int32 Local) { return FIntPoint{Bounds.Min.X + Local % LocalWidth, Bounds.Min.Y + Local / LocalWidth}; };
+
+	ScratchCosts.assign(NumLocal, MAX_flt);
+	ScratchParents.assign(NumLocal, INDEX_NONE);
+	ScratchClosed.assign(NumLocal, 0);
+	ScratchOpen.clear();
+
+	const int32 StartLocal = ToLocal(From);
+	const int32 GoalLocal = ToLocal(To);
+	ScratchCosts[StartLocal] = 0.f;
+	ScratchOpen.push_back({OctileDistance(From, To), StartLocal});
+
+	while (!ScratchOpen.empty())
+	{
+		std::pop_heap(ScratchOpen.begin(), ScratchOpen.end(), std::greater<>{});
+		const int32 Current = ScratchOpen.back().LocalIndex;
+		ScratchOpen.pop_back();
+
+		if (ScratchClosed[Current])
+			continue;
+		ScratchClosed[Current] = 1;
+
+		if (Current == GoalLocal)
+			break;
+
+		const FIntPoint CurrentCell = ToCell(Current);
+		ForEachNeighbor(CurrentCell, Bounds, [&](const FIntPoint& Neighbor, float StepCost)
+		{
+			const int32 NeighborLocal = ToLocal(Neighbor);
+			const float NewCost = ScratchCosts[Current] + StepCost;
+			if (ScratchClosed[NeighborLocal] || NewCost >= ScratchCosts[NeighborLocal])
+				return;
+
+			ScratchCosts[NeighborLocal] = NewCost;
+			ScratchParents[NeighborLocal] = Current;
+			ScratchOpen.push_back({NewCost + OctileDistance(Neighbor, To), NeighborLocal});
+			std::push_heap(ScratchOpen.begin(), ScratchOpen.end(), std::greater<>{});
+		});
+	}
+
+	if (!ScratchClosed[GoalLocal])
+		return false;
+
+	for (int32 Local = GoalLocal; Local != INDEX_NONE; Local = ScratchParents[Local])
+	{
+		OutCells.push_back(ToCell(Local));
+	}
+	std::reverse(OutCells.begin(), OutCells.end());
+
+	return true;
+}
+
+void FPathGrid::ComputeCostField(const FIntPoint& From, const FIntRect& Bounds, std::vector<float>& OutCosts) const
+{
+	const int32 LocalWidth = Bounds.Width();
+	const size_t NumLocal = static_cast<size_t>(LocalWidth) * Bounds.Height();
+	auto ToLocal = [&Bounds, LocalWidth](const FIntPoint& Cell) { return (Cell.Y - Bounds.Min.Y) * LocalWidth + (Cell.X - Bounds.Min.X); };
+	auto ToCell = [&Bounds, LocalWidth](int32 Local) { return FIntPoint{Bounds.Min.X + Local % LocalWidth, Bounds.Min.Y + Local / LocalWidth}; };
+
+	OutCosts.assign(NumLocal, MAX_flt);
+	if (!Bounds.Contains(From) || !IsWalkable(From))
+		return;
+
+	ScratchClosed.assign(NumLocal, 0);
+	ScratchOpen.clear();
+
+	const int32 StartLocal = ToLocal(From);
+	OutCosts[StartLocal] = 0.f;
+	ScratchOpen.push_back({0.f, StartLocal});
+
+	while (!ScratchOpen.empty())
+	{
+		std::pop_heap(ScratchOpen.begin(), ScratchOpen.end(), std::greater<>{});
+		const int32 Current = ScratchOpen.back().LocalIndex;
+		ScratchOpen.pop_back();
+
+		if (ScratchClosed[Current])
+			continue;
+		ScratchClosed[Current] = 1;
+
+		ForEachNeighbor(ToCell(Current), Bounds, [&](const FIntPoint& Neighbor, float StepCost)
+		{
+			const int32 NeighborLocal = ToLocal(Neighbor);
+			const float NewCost = OutCosts[Current] + StepCost;
+			if (ScratchClosed[NeighborLocal] || NewCost >= OutCosts[NeighborLocal])
+				return;
+
+			OutCosts[NeighborLocal] = NewCost;
+			ScratchOpen.push_back({NewCost, NeighborLocal});
+			std::push_heap(ScratchOpen.begin(), ScratchOpen.end(), std::greater<>{});
+		});
+	}
+}
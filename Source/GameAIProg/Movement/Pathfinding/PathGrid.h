@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <vector>
+
+/*
+ * Uniform walkability grid used by the pathfinders.
+ *
+ * Cells are 8-connected, diagonal moves are only allowed when both orthogonal neighbours are walkable (no corner cutting).
+ * All searches take a Bounds rect so the hierarchical pathfinder can restrict them to one cluster.
+ */
+class FPathGrid
+{
+public:
+	FPathGrid() = default;
+	FPathGrid(int32 InWidth, int32 InHeight, float InCellSize, const FVector2D& InOrigin = FVector2D::ZeroVector);
+
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+	float GetCellSize() const { return CellSize; }
+	const FVector2D& GetOrigin() const { return Origin; }
+	FIntRect GetBounds() const { return FIntRect{0, 0, Width, Height}; }
+
+	bool IsInBounds(const FIntPoint& Cell) const { return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Width && Cell.Y < Height; }
+	bool IsWalkable(const FIntPoint& Cell) const { return IsInBounds(Cell) && Walkable[ToIndex(Cell)] != 0; }
+	void SetWalkable(const FIntPoint& Cell, bool bWalkable);
+
+	int32 ToIndex(const FIntPoint& Cell) const { return Cell.Y * Width + Cell.X; }
+	FIntPoint WorldToCell(const FVector2D& WorldPos) const;
+	FVector2D CellToWorld(const FIntPoint& Cell) const; // center of the cell
+
+	// A* from From to To, only visiting cells inside Bounds. OutCells includes both end points.
+	bool FindPath(const FIntPoint& From, const FIntPoint& To, const FIntRect& Bounds, std::vector<FIntPoint>& OutCells) const;
+
+	// Dijkstra from From over Bounds. OutCosts is indexed locally to Bounds (row major), unreachable cells hold MAX_flt.
+	void ComputeCostField(const FIntPoint& From, const FIntRect& Bounds, std::vector<float>& OutCosts) const;
+
+	static float OctileDistance(const FIntPoint& A, const FIntPoint& B);
+
+private:
+	struct FOpenEntry
+	{
+		float Cost;
+		int32 LocalIndex;
+
+		bool operator>(const FOpenEntry& Other) const { return Cost > Other.Cost; }
+	};
+
+	int32 Width{0};
+	int32 Height{0};
+	float CellSize{100.f};
+	FVector2D Origin{FVector2D::ZeroVector}; // world position of the bottom left corner of cell (0,0)
+
+	std::vector<uint8> Walkable{};
+
+	// Search scratch, kept around so repeated queries don't allocate
+	mutable std::vector<float> ScratchCosts{};
+	mutable std::vector<int32> ScratchParents{};
+	mutable std::vector<uint8> ScratchClosed{};
+	mutable std::vector<FOpenEntry> ScratchOpen{};
+
+	template<typename FVisitor>
+	void ForEachNeighbor(const FIntPoint& Cell, const FIntRect& Bounds, FVisitor&& Visit) const;
+};
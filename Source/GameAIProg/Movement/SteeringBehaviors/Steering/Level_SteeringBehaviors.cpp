@@ -5,6 +5,10 @@
 #include <format>
 #include <string>
 #include "imgui.h"
+#include "GameAIProg/DecisionMaking/Perception/SteeringPerceptionSubsystem.h"
+#include "GameAIProg/GameAIProg.h"
+#include "SteeringSnapshot.h"
+#include "Misc/App.h"
 
 
 // Sets default values
@@ -21,11 +25,31 @@ void ALevel_SteeringBehaviors::BeginPlay()
 
 	AddAgent(BehaviorTypes::Seek);
 	SteeringAgents[0].Agent->SetDebugRenderingEnabled(true);
+
+	// Covers the largest trim world size
+	InfluenceMap = std::make_unique<FInfluenceMap>(128, 128, 50.f, FVector2D{-3200.f, -3200.f});
+	InfluenceMapVisualizer = std::make_unique<FInfluenceMapVisualizer>(TEXT("SteeringInfluenceMap"), *InfluenceMap);
+}
+
+void ALevel_SteeringBehaviors::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// The fixed time step is engine-wide, it must not outlive a replay that was interrupted
+	if (SessionMode == SessionModes::Replaying)
+	{
+		FApp::SetUseFixedTimeStep(false);
+		SessionMode = SessionModes::Live;
+	}
+	bSessionModeChangePending = false;
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ALevel_SteeringBehaviors::BeginDestroy()
 {
 	Super::BeginDestroy();
+
+	InfluenceMapVisualizer.reset();
+	InfluenceMap.reset();
 }
 
 // Called every frame
@@ -33,6 +57,9 @@ void ALevel_SteeringBehaviors::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	if (bSessionModeChangePending)
+		ChangeSessionMode();
+
 #pragma region UI
 	ImGui::SetNextWindowPos(WindowPos);
 	ImGui::SetNextWindowSize(WindowSize);
@@ -66,18 +93,82 @@ void ALevel_SteeringBehaviors::Tick(float DeltaTime)
 	ImGui::Spacing();
 	ImGui::Spacing();
 	
-	ImGui::Checkbox("Trim World", &TrimWorld->bShouldTrimWorld);
+	bool bTrimWorld = TrimWorld->bShouldTrimWorld;
+	if (ImGui::Checkbox("Trim World", &bTrimWorld))
+		SubmitEvent({ESteeringSessionEvent::SetTrimWorld, INDEX_NONE, bTrimWorld, TrimWorld->GetTrimWorldSize()});
 	if (TrimWorld->bShouldTrimWorld)
 	{
 		ImGuiHelpers::ImGuiSliderFloatWithSetter("Trim Size",
 			TrimWorld->GetTrimWorldSize(), 1000.f, 3000.f,
-			[this](float InVal) { TrimWorld->SetTrimWorldSize(InVal); });
+			[this](float InVal) { SubmitEvent({ESteeringSessionEvent::SetTrimWorld, INDEX_NONE, true, InVal}); });
+	}
+	ImGui::Spacing();
+
+	if (ImGui::CollapsingHeader("Session"))
+	{
+		switch (SessionMode)
+		{
+		case SessionModes::Live:
+			if (ImGui::Button("Record"))
+				RequestSessionMode(SessionModes::Recording);
+			ImGui::SameLine();
+			if (ImGui::Button("Replay"))
+				RequestSessionMode(SessionModes::Replaying);
+			if (ImGui::Button("Save Snapshot"))
+				SaveSnapshot();
+			ImGui::SameLine();
+			if (ImGui::Button("Load Snapshot"))
+				LoadSnapshot();
+			break;
+		case SessionModes::Recording:
+			ImGui::Text("Recording frame %d", SessionLog.Frames.Num());
+			if (ImGui::Button("Stop & Save"))
+				RequestSessionMode(SessionModes::Live);
+			break;
+		case SessionModes::Replaying:
+			ImGui::Text("Replaying frame %d / %d", ReplayFrame, SessionLog.Frames.Num());
+			if (ImGui::Button("Stop"))
+				RequestSessionMode(SessionModes::Live);
+			break;
+		}
+		ImGui::Text("Checksum mismatches: %d", ReplayMismatches);
+	}
+	ImGui::Spacing();
+
+	if (InfluenceMap && ImGui::CollapsingHeader("Influence Map"))
+	{
+		ImGui::Checkbox("Enabled", &bUseInfluenceMap);
+
+		ImGuiHelpers::ImGuiSliderFloatWithSetter("Spread",
+			InfluenceMap->GetSpread(), 0.f, 1.f,
+			[this](float InVal) { InfluenceMap->SetSpread(InVal); }, "%.2f");
+		ImGuiHelpers::ImGuiSliderFloatWithSetter("Decay",
+			InfluenceMap->GetDecayRate(), 0.f, 5.f,
+			[this](float InVal) { InfluenceMap->SetDecayRate(InVal); }, "%.2f");
+
+		ImGui::Text("Active tiles: %d", InfluenceMap->GetNumActiveTiles());
+		if (bUseInfluenceMap)
+		{
+			InfluenceMapVisualizer->UpdateTexture();
+			InfluenceMapVisualizer->DrawImGui(ImGui::GetContentRegionAvail().x);
+		}
+	}
+	ImGui::Spacing();
+
+	if (ImGui::CollapsingHeader("Perception"))
+	{
+		bool bPerceive = bUsePerception;
+		if (ImGui::Checkbox("Agents pick targets", &bPerceive))
+			SubmitEvent({ESteeringSessionEvent::SetUsePerception, INDEX_NONE, bPerceive});
+
+		if (const USteeringPerceptionSubsystem* Perception = GetWorld()->GetSubsystem<USteeringPerceptionSubsystem>())
+			ImGui::Text("Perceiving agents: %d", Perception->GetNumAgents());
 	}
 	ImGui::Spacing();
 
 #pragma region PerAgentUI
 	if (ImGui::Button("Add Agent"))
-		AddAgent(BehaviorTypes::Seek);
+		SubmitEvent({ESteeringSessionEvent::AddAgent, INDEX_NONE, static_cast<int32>(BehaviorTypes::Seek)});
 	ImGui::Separator();
 
 	for (int i{0}; i < SteeringAgents.size(); ++i)
@@ -94,18 +185,16 @@ void ALevel_SteeringBehaviors::Tick(float DeltaTime)
 			{
 				float v = a.Agent->GetMaxLinearSpeed();
 				if (ImGui::SliderFloat("Lin", &v, 0.f, 600.f, "%.2f"))
-					a.Agent->SetMaxLinearSpeed(v);
+					SubmitEvent({ESteeringSessionEvent::SetMaxLinearSpeed, i, 0, v});
 
 				v = a.Agent->GetMaxAngularSpeed();
 				if (ImGui::SliderFloat("Ang", &v, 0.f, 360.f, "%.2f"))
-					a.Agent->SetMaxAngularSpeed(v);
+					SubmitEvent({ESteeringSessionEvent::SetMaxAngularSpeed, i, 0, v});
 
 				v = a.Agent->GetMass();
 				if (ImGui::SliderFloat("Mass ", &v, 0.f, 100.f, "%.2f"))
-					a.Agent->SetMass(v);
+					SubmitEvent({ESteeringSessionEvent::SetMass, i, 0, v});
 			}
-			
-			bool bBehaviourModified = false;
 
 			ImGui::Spacing();
 			ImGui::PushID(i + 50);
@@ -114,9 +203,10 @@ void ALevel_SteeringBehaviors::Tick(float DeltaTime)
 			ImGui::PushItemWidth(100);
 
 			// Add the names of your steering behaviors
-			if (ImGui::Combo("", &a.SelectedBehavior, "Seek\0Wander\0Flee\0Arrive\0Face\0Evade\0Pursuit", 7))
+			int selectedBehavior = a.SelectedBehavior;
+			if (ImGui::Combo("", &selectedBehavior, "Seek\0Wander\0Flee\0Arrive\0Face\0Evade\0Pursuit", 7))
 			{
-				bBehaviourModified = true;
+				SubmitEvent({ESteeringSessionEvent::SetBehavior, i, selectedBehavior});
 			}
 			ImGui::PopItemWidth();
 			ImGui::PopID();
@@ -138,18 +228,13 @@ void ALevel_SteeringBehaviors::Tick(float DeltaTime)
 			}
 			if (ImGui::Combo(Label.c_str(), &selectedTargetOffset, Targets.c_str()))
 			{
-				a.SelectedTarget = selectedTargetOffset - 1;
-				bBehaviourModified = true;
+				SubmitEvent({ESteeringSessionEvent::SetTarget, i, selectedTargetOffset - 1});
 			}
-			
+
 			ImGui::PopItemWidth();
 			ImGui::PopID();
 			ImGui::Spacing();
 			ImGui::Spacing();
-			
-			
-			if (bBehaviourModified)
-				SetAgentBehavior(a);
 
 			if (ImGui::Button("x"))
 			{
@@ -173,45 +258,102 @@ void ALevel_SteeringBehaviors::Tick(float DeltaTime)
 
 	if (AgentIndexToRemove >= 0)
 	{
-		RemoveAgent(AgentIndexToRemove);
+		SubmitEvent({ESteeringSessionEvent::RemoveAgent, AgentIndexToRemove});
 		AgentIndexToRemove = -1;
 	}
-	
+
 	ImGui::End();
 #pragma endregion
 
+	// Note: MouseTarget is written by the Level BP on every click, a replay overrides it with the recorded one
+	if (SessionMode == SessionModes::Replaying)
+	{
+		if (ReplayFrame < SessionLog.Frames.Num())
+		{
+			for (const FSteeringSessionEvent& Event : SessionLog.Frames[ReplayFrame].Events)
+			{
+				ApplyEvent(Event);
+			}
+		}
+		MouseTarget.Position = SessionMouseTarget;
+	}
+	else if (MouseTarget.Position != SessionMouseTarget)
+	{
+		SubmitEvent({ESteeringSessionEvent::SetMouseTarget, INDEX_NONE, 0, 0.f, MouseTarget.Position});
+	}
+
+	USteeringPerceptionSubsystem* const Perception = GetWorld()->GetSubsystem<USteeringPerceptionSubsystem>();
+	if (bUsePerception && Perception && MouseTarget.Position != LastNoiseLocation)
+	{
+		Perception->ReportNoise(MouseTarget.Position, 3000.f);
+		LastNoiseLocation = MouseTarget.Position;
+	}
+
+	// Influence per second, stamped every frame but decayed in fixed steps: scaled by the frame time so the field
+	// doesn't grow with the frame rate
+	constexpr float StampRate{60.f};
 	for (ImGui_Agent& a : SteeringAgents)
 	{
 		if (a.Agent)
 		{
-			UpdateTarget(a);
+			if (!bUsePerception)
+				UpdateTarget(a);
+
+			if (bUseInfluenceMap)
+				InfluenceMap->Stamp(a.Agent->GetPosition(), StampRate * DeltaTime, 150.f);
 		}
 	}
+
+	if (bUseInfluenceMap)
+		InfluenceMap->Update(DeltaTime);
+
+	EndFrame(DeltaTime);
 }
 
 bool ALevel_SteeringBehaviors::AddAgent(BehaviorTypes BehaviorType, bool AutoOrient)
+{
+	if (SpawnAgent(BehaviorType, FVector{0,0,90}, FRotator::ZeroRotator))
+	{
+		RefreshTargetLabels();
+
+		return true;
+	}
+
+	return false;
+}
+
+ALevel_SteeringBehaviors::ImGui_Agent* ALevel_SteeringBehaviors::SpawnAgent(BehaviorTypes BehaviorType, const FVector& Location,
+	const FRotator& Rotation, bool bSetupBehavior)
 {
 	ImGui_Agent ImGuiAgent = {};
-	ImGuiAgent.Agent = GetWorld()->SpawnActor<ASteeringAgent>(SteeringAgentClass, FVector{0,0,90}, FRotator::ZeroRotator);
+	ImGuiAgent.Agent = GetWorld()->SpawnActor<ASteeringAgent>(SteeringAgentClass, Location, Rotation);
 	if (IsValid(ImGuiAgent.Agent))
 	{
 		ImGuiAgent.SelectedBehavior = static_cast<int>(BehaviorType);
 		ImGuiAgent.SelectedTarget = -1; // Mouse
+		ImGuiAgent.Seed = SessionSeed ^ NumAgentsSpawned++;
 		
-		SetAgentBehavior(ImGuiAgent);
+		if (bSetupBehavior)
+			SetAgentBehavior(ImGuiAgent);
 
-		SteeringAgents.push_back(std::move(ImGuiAgent));
-		
-		RefreshTargetLabels();
+		if (USteeringPerceptionSubsystem* Perception = GetWorld()->GetSubsystem<USteeringPerceptionSubsystem>())
+		{
+			FPerceptionConfig Config{};
+			Config.bDriveSteeringTarget = bUsePerception;
+			Perception->RegisterAgent(ImGuiAgent.Agent, Config);
+		}
 
-		return true;
+		return &SteeringAgents.emplace_back(std::move(ImGuiAgent));
 	}
 
-	return false;
+	return nullptr;
 }
 
 void ALevel_SteeringBehaviors::RemoveAgent(unsigned int Index)
 {
+	if (USteeringPerceptionSubsystem* Perception = GetWorld()->GetSubsystem<USteeringPerceptionSubsystem>())
+		Perception->UnregisterAgent(SteeringAgents[Index].Agent);
+
 	SteeringAgents[Index].Agent->Destroy();
 	SteeringAgents.erase(SteeringAgents.begin() + Index);
 
@@ -219,6 +361,20 @@ void ALevel_SteeringBehaviors::RemoveAgent(unsigned int Index)
 	RefreshAgentTargets(Index);
 }
 
+void ALevel_SteeringBehaviors::RemoveAllAgents()
+{
+	USteeringPerceptionSubsystem* const Perception = GetWorld()->GetSubsystem<USteeringPerceptionSubsystem>();
+	for (ImGui_Agent& a : SteeringAgents)
+	{
+		if (Perception)
+			Perception->UnregisterAgent(a.Agent);
+		a.Agent->Destroy();
+	}
+	SteeringAgents.clear();
+
+	RefreshTargetLabels();
+}
+
 void ALevel_SteeringBehaviors::SetAgentBehavior(ImGui_Agent& Agent)
 {
 	Agent.Behavior.reset();
@@ -246,8 +402,12 @@ void ALevel_SteeringBehaviors::SetAgentBehavior(ImGui_Agent& Agent)
 		Agent.Behavior = std::make_unique<Evade>();
 		break;
 	case BehaviorTypes::Wander:
-		Agent.Behavior = std::make_unique<Wander>();
+	{
+		std::unique_ptr<Wander> WanderBehavior = std::make_unique<Wander>();
+		WanderBehavior->SetSeed(Agent.Seed);
+		Agent.Behavior = std::move(WanderBehavior);
 		break;
+	}
 	default:
 		assert(false); // Incorrect Agent Behavior gotten during SetAgentBehavior()	
 	}
@@ -306,3 +466,317 @@ void ALevel_SteeringBehaviors::RefreshAgentTargets(unsigned int IndexRemoved)
 	}
 }
 
+void ALevel_SteeringBehaviors::RefreshPerceptionConfigs()
+{
+	USteeringPerceptionSubsystem* const Perception = GetWorld()->GetSubsystem<USteeringPerceptionSubsystem>();
+	if (!Perception)
+		return;
+
+	FPerceptionConfig Config{};
+	Config.bDriveSteeringTarget = bUsePerception;
+	for (ImGui_Agent& a : SteeringAgents)
+	{
+		Perception->SetConfig(a.Agent, Config);
+	}
+}
+
+void ALevel_SteeringBehaviors::SubmitEvent(const FSteeringSessionEvent& Event)
+{
+	// The replayed session is the only input while replaying
+	if (SessionMode == SessionModes::Replaying)
+		return;
+
+	ApplyEvent(Event);
+
+	if (SessionMode == SessionModes::Recording)
+		FrameEvents.Add(Event);
+}
+
+void ALevel_SteeringBehaviors::ApplyEvent(const FSteeringSessionEvent& Event)
+{
+	const bool bNeedsAgent = Event.Type != ESteeringSessionEvent::AddAgent
+		&& Event.Type != ESteeringSessionEvent::SetMouseTarget
+		&& Event.Type != ESteeringSessionEvent::SetTrimWorld
+		&& Event.Type != ESteeringSessionEvent::SetUsePerception;
+	if (bNeedsAgent && (Event.Agent < 0 || Event.Agent >= static_cast<int32>(SteeringAgents.size())))
+	{
+		UE_LOG(LogGameAIProg, Warning, TEXT("Session event %d refers to agent %d, there are only %d"),
+			static_cast<int32>(Event.Type), Event.Agent, static_cast<int32>(SteeringAgents.size()));
+		return;
+	}
+
+	switch (Event.Type)
+	{
+	case ESteeringSessionEvent::AddAgent:
+		AddAgent(static_cast<BehaviorTypes>(FMath::Clamp(Event.IntValue, 0, static_cast<int32>(BehaviorTypes::Count) - 1)));
+		break;
+	case ESteeringSessionEvent::RemoveAgent:
+		RemoveAgent(Event.Agent);
+		break;
+	case ESteeringSessionEvent::SetBehavior:
+		SteeringAgents[Event.Agent].SelectedBehavior = FMath::Clamp(Event.IntValue, 0, static_cast<int32>(BehaviorTypes::Count) - 1);
+		SetAgentBehavior(SteeringAgents[Event.Agent]);
+		break;
+	case ESteeringSessionEvent::SetTarget:
+		SteeringAgents[Event.Agent].SelectedTarget = FMath::Clamp(Event.IntValue, -1, static_cast<int32>(SteeringAgents.size()) - 1);
+		SetAgentBehavior(SteeringAgents[Event.Agent]);
+		break;
+	case ESteeringSessionEvent::SetMaxLinearSpeed:
+		SteeringAgents[Event.Agent].Agent->SetMaxLinearSpeed(Event.FloatValue);
+		break;
+	case ESteeringSessionEvent::SetMaxAngularSpeed:
+		SteeringAgents[Event.Agent].Agent->SetMaxAngularSpeed(Event.FloatValue);
+		break;
+	case ESteeringSessionEvent::SetMass:
+		SteeringAgents[Event.Agent].Agent->SetMass(Event.FloatValue);
+		break;
+	case ESteeringSessionEvent::SetMouseTarget:
+		SessionMouseTarget = Event.Vector;
+		MouseTarget.Position = Event.Vector;
+		break;
+	case ESteeringSessionEvent::SetTrimWorld:
+		TrimWorld->bShouldTrimWorld = Event.IntValue != 0;
+		TrimWorld->SetTrimWorldSize(Event.FloatValue);
+		break;
+	case ESteeringSessionEvent::SetUsePerception:
+		bUsePerception = Event.IntValue != 0;
+		RefreshPerceptionConfigs();
+		break;
+	default:
+		assert(false); // Unknown session event
+	}
+}
+
+void ALevel_SteeringBehaviors::RequestSessionMode(SessionModes NewMode)
+{
+	// Applied at the start of the next frame, so no frame is half recorded or half replayed
+	PendingSessionMode = NewMode;
+	bSessionModeChangePending = true;
+
+	if (NewMode == SessionModes::Replaying)
+	{
+		if (!SessionLog.LoadFromFile(FSteeringSessionLog::GetDefaultPath()) || SessionLog.Frames.IsEmpty())
+		{
+			UE_LOG(LogGameAIProg, Warning, TEXT("No session to replay at '%s'"), *FSteeringSessionLog::GetDefaultPath());
+			bSessionModeChangePending = false;
+		}
+	}
+}
+
+void ALevel_SteeringBehaviors::ChangeSessionMode()
+{
+	bSessionModeChangePending = false;
+
+	if (SessionMode == SessionModes::Recording)
+	{
+		const FString Path = FSteeringSessionLog::GetDefaultPath();
+		if (SessionLog.SaveToFile(Path))
+			UE_LOG(LogGameAIProg, Log, TEXT("Saved %d session frames to '%s'"), SessionLog.Frames.Num(), *Path);
+	}
+	else if (SessionMode == SessionModes::Replaying)
+	{
+		FApp::SetUseFixedTimeStep(false);
+		UE_LOG(LogGameAIProg, Log, TEXT("Replayed %d of %d session frames, %d checksum mismatches"),
+			ReplayFrame, SessionLog.Frames.Num(), ReplayMismatches);
+	}
+
+	SessionMode = PendingSessionMode;
+
+	switch (SessionMode)
+	{
+	case SessionModes::Live:
+		break;
+	case SessionModes::Recording:
+	{
+		// The initial setup is the first frame's events: one seeking agent in whatever world the user had set up
+		SessionLog = {};
+		SessionLog.Seed = FPlatformTime::Cycles64();
+		SessionSeed = SessionLog.Seed;
+		FrameEvents.Reset();
+		ResetSession();
+
+		SubmitEvent({ESteeringSessionEvent::SetMouseTarget, INDEX_NONE, 0, 0.f, MouseTarget.Position});
+		SubmitEvent({ESteeringSessionEvent::SetTrimWorld, INDEX_NONE, TrimWorld->bShouldTrimWorld, TrimWorld->GetTrimWorldSize()});
+		SubmitEvent({ESteeringSessionEvent::SetUsePerception, INDEX_NONE, bUsePerception});
+		SubmitEvent({ESteeringSessionEvent::AddAgent, INDEX_NONE, static_cast<int32>(BehaviorTypes::Seek)});
+		break;
+	}
+	case SessionModes::Replaying:
+		// Applies from the next engine frame. This one only replays the initial setup, which spawns the agents and
+		// doesn't depend on the delta time
+		FApp::SetUseFixedTimeStep(true);
+		FApp::SetFixedDeltaTime(SessionLog.Frames[0].DeltaTime);
+		SessionSeed = SessionLog.Seed;
+		ReplayFrame = 0;
+		ReplayMismatches = 0;
+		ResetSession();
+		break;
+	}
+}
+
+void ALevel_SteeringBehaviors::ResetSession()
+{
+	RemoveAllAgents();
+	NumAgentsSpawned = 0;
+}
+
+void ALevel_SteeringBehaviors::EndFrame(float DeltaTime)
+{
+	if (SessionMode == SessionModes::Recording)
+	{
+		FSteeringSessionFrame& Frame = SessionLog.Frames.AddDefaulted_GetRef();
+		Frame.DeltaTime = DeltaTime;
+		Frame.Checksum = ComputeChecksum();
+		Frame.Events = MoveTemp(FrameEvents);
+		FrameEvents.Reset();
+	}
+	else if (SessionMode == SessionModes::Replaying && ReplayFrame < SessionLog.Frames.Num())
+	{
+		const uint32 Checksum = ComputeChecksum();
+		if (Checksum != SessionLog.Frames[ReplayFrame].Checksum)
+		{
+			if (ReplayMismatches == 0)
+				UE_LOG(LogGameAIProg, Warning, TEXT("Replay diverged from the recorded session at frame %d"), ReplayFrame);
+			++ReplayMismatches;
+		}
+
+		++ReplayFrame;
+		if (ReplayFrame < SessionLog.Frames.Num())
+			FApp::SetFixedDeltaTime(SessionLog.Frames[ReplayFrame].DeltaTime);
+		else
+			RequestSessionMode(SessionModes::Live);
+	}
+}
+
+uint32 ALevel_SteeringBehaviors::ComputeChecksum() const
+{
+	// Quantized to a hundredth of a unit and degree, so float noise below that doesn't count as a divergence
+	TArray<int32, TInlineAllocator<64>> State;
+	State.Reserve(static_cast<int32>(SteeringAgents.size()) * 3);
+	for (const ImGui_Agent& a : SteeringAgents)
+	{
+		const FVector2D Position = a.Agent->GetPosition();
+		State.Add(FMath::RoundToInt(Position.X * 100.f));
+		State.Add(FMath::RoundToInt(Position.Y * 100.f));
+		State.Add(FMath::RoundToInt(a.Agent->GetRotation() * 100.f));
+	}
+
+	return FCrc::MemCrc32(State.GetData(), State.Num() * sizeof(int32));
+}
+
+void ALevel_SteeringBehaviors::SaveSnapshot()
+{
+	TArray<FSteeringSnapshotAgent> Records;
+	Records.SetNum(static_cast<int32>(SteeringAgents.size()));
+
+	for (int32 i{0}; i < Records.Num(); ++i)
+	{
+		const ImGui_Agent& a = SteeringAgents[i];
+		FSteeringSnapshotAgent& Record = Records[i];
+
+		Record.SetKinematics(FSteeringParams{a.Agent->GetPosition(), a.Agent->GetRotation(), a.Agent->GetLinearVelocity(),
+			a.Agent->GetAngularVelocity()});
+		Record.MaxLinearSpeed = a.Agent->GetMaxLinearSpeed();
+		Record.MaxAngularSpeed = a.Agent->GetMaxAngularSpeed();
+		Record.Mass = a.Agent->GetMass();
+		Record.Behavior = static_cast<uint8>(a.SelectedBehavior);
+		Record.Target = a.SelectedTarget;
+		Record.bAutoOrient = a.Agent->IsAutoOrienting();
+		Record.bDebugRendering = a.Agent->GetDebugRenderingEnabled();
+		Record.Seed = a.Seed;
+
+		if (static_cast<BehaviorTypes>(a.SelectedBehavior) == BehaviorTypes::Wander)
+		{
+			const Wander* const WanderBehavior = static_cast<const Wander*>(a.Behavior.get());
+			Record.RandomSeed = WanderBehavior->GetRandom().Seed;
+			Record.RandomCounter = WanderBehavior->GetRandom().Counter;
+			Record.WanderOffset = WanderBehavior->GetWanderOffset();
+			Record.WanderRadius = WanderBehavior->GetWanderRadius();
+			Record.WanderMaxAngleChange = WanderBehavior->GetWanderMaxAngleChange();
+			Record.WanderAngle = WanderBehavior->GetWanderAngle();
+		}
+	}
+
+	const FString Path = FSteeringSnapshot::GetDefaultPath();
+	if (FSteeringSnapshot::Save(Path, FVector2f{MouseTarget.Position}, Records))
+		UE_LOG(LogGameAIProg, Log, TEXT("Saved %d agents to '%s'"), Records.Num(), *Path);
+}
+
+void ALevel_SteeringBehaviors::LoadSnapshot()
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	FSteeringSnapshot Snapshot;
+	if (!Snapshot.Open(FSteeringSnapshot::GetDefaultPath()))
+		return;
+
+	const double OpenTime = FPlatformTime::Seconds();
+
+	RemoveAllAgents();
+
+	const TConstArrayView<FSteeringSnapshotAgent> Records = Snapshot.GetAgents();
+	SteeringAgents.reserve(Records.Num());
+
+	MouseTarget.Position = FVector2D{Snapshot.GetMouseTarget()};
+	SessionMouseTarget = MouseTarget.Position;
+
+	// Spawn everyone first, targets may point at agents further down the snapshot. Behaviors are set up once seed and
+	// target are known
+	TArray<int32> SpawnedRecords;
+	SpawnedRecords.Reserve(Records.Num());
+	for (int32 i{0}; i < Records.Num(); ++i)
+	{
+		const FSteeringSnapshotAgent& Record = Records[i];
+		const BehaviorTypes Behavior = static_cast<BehaviorTypes>(FMath::Min<int32>(Record.Behavior, static_cast<int32>(BehaviorTypes::Count) - 1));
+		const FSteeringParams Kinematics = Record.GetKinematics();
+
+		ImGui_Agent* const a = SpawnAgent(Behavior, FVector{Kinematics.Position, 90.f}, FRotator{0.f, Kinematics.Orientation, 0.f}, false);
+		if (a)
+			SpawnedRecords.Add(i);
+	}
+	NumAgentsSpawned = SteeringAgents.size();
+
+	// Agents that failed to spawn shift the indices of the ones after them, targets are remapped accordingly
+	TArray<int32> AgentOfRecord;
+	AgentOfRecord.Init(INDEX_NONE, Records.Num());
+	for (int32 i{0}; i < SpawnedRecords.Num(); ++i)
+	{
+		AgentOfRecord[SpawnedRecords[i]] = i;
+	}
+
+	for (int32 i{0}; i < SpawnedRecords.Num(); ++i)
+	{
+		const FSteeringSnapshotAgent& Record = Records[SpawnedRecords[i]];
+		ImGui_Agent& a = SteeringAgents[i];
+
+		a.Seed = Record.Seed;
+		a.SelectedTarget = Records.IsValidIndex(Record.Target) ? AgentOfRecord[Record.Target] : -1;
+		SetAgentBehavior(a);
+
+		if (static_cast<BehaviorTypes>(a.SelectedBehavior) == BehaviorTypes::Wander)
+		{
+			Wander* const WanderBehavior = a.Behavior->As<Wander>();
+			FCounterRandom Random;
+			Random.Seed = Record.RandomSeed;
+			Random.Counter = Record.RandomCounter;
+			WanderBehavior->SetRandom(Random);
+			WanderBehavior->SetWanderOffset(Record.WanderOffset);
+			WanderBehavior->SetWanderRadius(Record.WanderRadius);
+			WanderBehavior->SetWanderMaxAngleChange(Record.WanderMaxAngleChange);
+			WanderBehavior->SetWanderAngle(Record.WanderAngle);
+		}
+
+		// After SetAgentBehavior, which resets the speed. Angular velocity follows from the rotation, it isn't restored
+		a.Agent->SetMaxLinearSpeed(Record.MaxLinearSpeed);
+		a.Agent->SetMaxAngularSpeed(Record.MaxAngularSpeed);
+		a.Agent->SetMass(Record.Mass);
+		a.Agent->SetIsAutoOrienting(Record.bAutoOrient != 0);
+		a.Agent->SetDebugRenderingEnabled(Record.bDebugRendering != 0);
+		a.Agent->GetCharacterMovement()->Velocity = FVector{Record.GetKinematics().LinearVelocity, 0.f};
+	}
+
+	RefreshTargetLabels();
+
+	UE_LOG(LogGameAIProg, Log, TEXT("Loaded %d agents from a snapshot: %.2f ms to open, %.2f ms to restore"), Records.Num(),
+		(OpenTime - StartTime) * 1000.0, (FPlatformTime::Seconds() - OpenTime) * 1000.0);
+}
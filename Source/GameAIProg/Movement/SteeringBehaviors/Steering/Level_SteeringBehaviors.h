@@ -9,6 +9,8 @@
 #include <string>
 
 #include "GameAIProg/Shared/Level_Base.h"
+#include "GameAIProg/DecisionMaking/InfluenceMaps/InfluenceMap.h"
+#include "SteeringSession.h"
 #include "Level_SteeringBehaviors.generated.h"
 
 UCLASS()
@@ -26,6 +28,9 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+
+	// Called when the game ends or the level is removed from the world
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 	virtual void BeginDestroy() override;
 
@@ -44,24 +49,70 @@ private:
 		Count
 	};
 
+	enum class SessionModes
+	{
+		Live,
+		Recording,
+		Replaying
+	};
+
 	struct ImGui_Agent final
 	{
 		ASteeringAgent* Agent{nullptr};
 		std::unique_ptr<ISteeringBehavior> Behavior{nullptr};
 		int SelectedBehavior{static_cast<int>(BehaviorTypes::Seek)};
 		int SelectedTarget = -1;
+		uint64 Seed{0}; // Wander draws from this, so a replay wanders the same way
 	};
 	
 	std::vector<ImGui_Agent> SteeringAgents{};
 	std::vector<std::string> TargetLabels{};
 	
 	int AgentIndexToRemove = -1;
-	
+
+	// Agents stamp their presence in here every frame
+	std::unique_ptr<FInfluenceMap> InfluenceMap{nullptr};
+	std::unique_ptr<FInfluenceMapVisualizer> InfluenceMapVisualizer{nullptr};
+	bool bUseInfluenceMap{false};
+
+	// Agents pick their own targets from what they see and hear, clicks are reported as noise
+	bool bUsePerception{false};
+	FVector2D LastNoiseLocation{FVector2D::ZeroVector};
+
+	// Everything that changes the simulation goes through SubmitEvent, so a session can be recorded and replayed
+	SessionModes SessionMode{SessionModes::Live};
+	SessionModes PendingSessionMode{SessionModes::Live};
+	bool bSessionModeChangePending{false};
+	FSteeringSessionLog SessionLog{};
+	TArray<FSteeringSessionEvent> FrameEvents{};
+	FVector2D SessionMouseTarget{FVector2D::ZeroVector};
+	uint64 SessionSeed{0};
+	uint64 NumAgentsSpawned{0};
+	int32 ReplayFrame{0};
+	int32 ReplayMismatches{0};
+
+	void SubmitEvent(const FSteeringSessionEvent& Event);
+	void ApplyEvent(const FSteeringSessionEvent& Event);
+	void RequestSessionMode(SessionModes NewMode);
+	void ChangeSessionMode();
+	void ResetSession();
+	void EndFrame(float DeltaTime);
+	uint32 ComputeChecksum() const;
+
 	bool AddAgent(BehaviorTypes BehaviorType = BehaviorTypes::Wander, bool AutoOrient = true);
+	// Labels aren't refreshed. Without bSetupBehavior the caller has to call SetAgentBehavior itself
+	ImGui_Agent* SpawnAgent(BehaviorTypes BehaviorType, const FVector& Location, const FRotator& Rotation, bool bSetupBehavior = true);
 	void RemoveAgent(unsigned int Index);
+	void RemoveAllAgents();
+
+	// The whole world in one file, restored without replaying how it was built
+	void SaveSnapshot();
+	void LoadSnapshot();
+
 	void SetAgentBehavior(ImGui_Agent& Agent);
 
 	void RefreshTargetLabels();
 	void UpdateTarget(ImGui_Agent& Agent);
 	void RefreshAgentTargets(unsigned int IndexRemoved);
+	void RefreshPerceptionConfigs();
 };
@@ -1,5 +1,6 @@
 #include "SteeringBehaviors.h"
 #include "GameAIProg/Movement/SteeringBehaviors/SteeringAgent.h"
+#include "GameAIProg/Shared/TrigTable.h"
 
 //*******
 // Week01 assignment
@@ -246,16 +247,35 @@ SteeringOutput Evade::CalculateSteering(float DeltaT, ASteeringAgent& Agent)
 // WANDER
 SteeringOutput Wander::CalculateSteering(float DeltaT, ASteeringAgent& Agent)
 {
+    // Every agent draws from its own stream, so wanderers can update in parallel and replay identically
+    if (!m_bIsSeeded)
+    {
+        SetSeed(GetTypeHash(Agent.GetFName()));
+    }
+
 	// Randomly adjust the wander angle within the specified maximum angle change
-    m_WanderAngle += ((float)rand() / RAND_MAX * 2.f - 1.f) * m_MaxAngleChange;
+    m_WanderAngle = FMath::UnwindRadians(m_WanderAngle + m_Random.NextSignedFloat() * m_MaxAngleChange);
 
     FVector2D agentPos = Agent.GetPosition();
     float agentRotRad = FMath::DegreesToRadians(Agent.GetRotation());
-    FVector2D agentDir = FVector2D(cos(agentRotRad), sin(agentRotRad));
 
+    float rotSin, rotCos, wanderSin, wanderCos;
+    if (m_bUseTrigTable)
+    {
+        TrigTable::SinCos(agentRotRad, rotSin, rotCos);
+        TrigTable::SinCos(m_WanderAngle, wanderSin, wanderCos);
+    }
+    else
+    {
+        FMath::SinCos(&rotSin, &rotCos, agentRotRad);
+        FMath::SinCos(&wanderSin, &wanderCos, m_WanderAngle);
+    }
+    FVector2D agentDir = FVector2D(rotCos, rotSin);
+
+    // Direction of (rotation + wander angle) by angle addition, no third sin/cos needed
     FVector2D circleCenter = agentPos + agentDir * m_OffsetDistance;
-    float totalAngle = agentRotRad + m_WanderAngle;
-    FVector2D wanderTarget = circleCenter + FVector2D(cos(totalAngle), sin(totalAngle)) * m_Radius;
+    FVector2D wanderDir = FVector2D(rotCos * wanderCos - rotSin * wanderSin, rotSin * wanderCos + rotCos * wanderSin);
+    FVector2D wanderTarget = circleCenter + wanderDir * m_Radius;
 
 	// Debug
     DrawBaseSteeringDebug(Agent, Agent.GetLinearVelocity(), (wanderTarget - agentPos).GetSafeNormal());
@@ -2,6 +2,7 @@
 
 #include <Movement/SteeringBehaviors/SteeringHelpers.h>
 #include "Kismet/KismetMathLibrary.h"
+#include "GameAIProg/Shared/CounterRandom.h"
 
 class ASteeringAgent;
 
@@ -108,10 +109,25 @@ public:
 	void SetWanderOffset(float offset) { m_OffsetDistance = offset; }
 	void SetWanderRadius(float radius) { m_Radius = radius; }
 	void SetWanderMaxAngleChange(float rad) { m_MaxAngleChange = rad; }
+	float GetWanderOffset() const { return m_OffsetDistance; }
+	float GetWanderRadius() const { return m_Radius; }
+	float GetWanderMaxAngleChange() const { return m_MaxAngleChange; }
+	float GetWanderAngle() const { return m_WanderAngle; }
+	void SetWanderAngle(float rad) { m_WanderAngle = rad; }
+
+	// Without an explicit seed the stream is seeded from the agent's name on the first update
+	void SetSeed(uint64 seed) { m_Random = FCounterRandom{seed}; m_bIsSeeded = true; }
+	const FCounterRandom& GetRandom() const { return m_Random; }
+	void SetRandom(const FCounterRandom& random) { m_Random = random; m_bIsSeeded = true; } // resumes a stream mid-way
+	void SetUseTrigTable(bool bUseTable) { m_bUseTrigTable = bUseTable; }
 
 protected:
 	float m_OffsetDistance = 100.f;
 	float m_Radius = 80.f;
 	float m_MaxAngleChange = 45.f * PI / 180.f;
 	float m_WanderAngle = 0.f;
+
+	FCounterRandom m_Random{};
+	bool m_bIsSeeded = false;
+	bool m_bUseTrigTable = true;
 };
\ No newline at end of file
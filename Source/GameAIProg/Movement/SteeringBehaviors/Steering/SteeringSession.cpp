@@ -0,0 +1,132 @@
+#include "SteeringSession.h"
+#include "GameAIProg/GameAIProg.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+FArchive& operator<<(FArchive& Ar, FSteeringSessionEvent& Event)
+{
+	uint8 Type = static_cast<uint8>(Event.Type);
+	Ar << Type;
+	Event.Type = static_cast<ESteeringSessionEvent>(Type);
+
+	switch (Event.Type)
+	{
+	case ESteeringSessionEvent::AddAgent:
+	case ESteeringSessionEvent::SetUsePerception:
+		Ar << Event.IntValue;
+		break;
+	case ESteeringSessionEvent::RemoveAgent:
+		Ar << Event.Agent;
+		break;
+	case ESteeringSessionEvent::SetBehavior:
+	case ESteeringSessionEvent::SetTarget:
+		Ar << Event.Agent << Event.IntValue;
+		break;
+	case ESteeringSessionEvent::SetMaxLinearSpeed:
+	case ESteeringSessionEvent::SetMaxAngularSpeed:
+	case ESteeringSessionEvent::SetMass:
+		Ar << Event.Agent << Event.FloatValue;
+		break;
+	case ESteeringSessionEvent::SetMouseTarget:
+		Ar << Event.Vector;
+		break;
+	case ESteeringSessionEvent::SetTrimWorld:
+		Ar << Event.IntValue << Event.FloatValue;
+		break;
+	default:
+		Ar.SetError();
+		break;
+	}
+
+	return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FSteeringSessionFrame& Frame)
+{
+	Ar << Frame.DeltaTime << Frame.Checksum;
+
+	// Most frames have no events at all, the count is packed to a single byte for them
+	uint32 NumEvents = static_cast<uint32>(Frame.Events.Num());
+	Ar.SerializeIntPacked(NumEvents);
+	if (Ar.IsLoading())
+	{
+		// Every event takes at least a byte, anything more is a corrupt log
+		if (NumEvents > static_cast<uint32>(Ar.TotalSize() - Ar.Tell()))
+		{
+			Ar.SetError();
+			return Ar;
+		}
+		Frame.Events.SetNum(static_cast<int32>(NumEvents));
+	}
+
+	for (FSteeringSessionEvent& Event : Frame.Events)
+	{
+		Ar << Event;
+	}
+
+	return Ar;
+}
+
+bool FSteeringSessionLog::SaveToFile(const FString& Path) const
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer{Bytes};
+
+	uint32 FileMagic{Magic};
+	uint32 FileVersion{Version};
+	uint64 FileSeed{Seed};
+	int32 NumFrames{Frames.Num()};
+	Writer << FileMagic << FileVersion << FileSeed << NumFrames;
+	for (const FSteeringSessionFrame& Frame : Frames)
+	{
+		Writer << const_cast<FSteeringSessionFrame&>(Frame);
+	}
+
+	return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+bool FSteeringSessionLog::LoadFromFile(const FString& Path)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+		return false;
+
+	FMemoryReader Reader{Bytes};
+
+	uint32 FileMagic{0};
+	uint32 FileVersion{0};
+	int32 NumFrames{0};
+	Reader << FileMagic << FileVersion;
+	if (FileMagic != Magic || FileVersion != Version)
+	{
+		UE_LOG(LogGameAIProg, Warning, TEXT("'%s' is not a steering session log of version %u"), *Path, Version);
+		return false;
+	}
+
+	Reader << Seed << NumFrames;
+	if (Reader.IsError() || NumFrames < 0)
+		return false;
+
+	// Every frame takes at least its delta time, checksum and packed event count, anything more is a corrupt log
+	constexpr int64 MinFrameSize{sizeof(float) + sizeof(uint32) + 1};
+	if (NumFrames > (Reader.TotalSize() - Reader.Tell()) / MinFrameSize)
+	{
+		UE_LOG(LogGameAIProg, Warning, TEXT("'%s' is truncated or corrupt"), *Path);
+		return false;
+	}
+
+	Frames.SetNum(NumFrames);
+	for (FSteeringSessionFrame& Frame : Frames)
+	{
+		Reader << Frame;
+	}
+
+	return !Reader.IsError();
+}
+
+FString FSteeringSessionLog::GetDefaultPath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Sessions") / TEXT("SteeringSession.gair");
+}
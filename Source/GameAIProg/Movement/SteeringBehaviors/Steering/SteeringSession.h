@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+ * Binary log of a steering session: the seed, every input event per frame, the frame's delta time and a checksum of the
+ * agents' state after the frame. Sessions always start from the same setup (the level resets when recording starts), so
+ * replaying the events reproduces the session and the checksums tell where it stopped doing so.
+ */
+enum class ESteeringSessionEvent : uint8
+{
+	AddAgent,           // IntValue: behavior
+	RemoveAgent,        // Agent
+	SetBehavior,        // Agent, IntValue: behavior
+	SetTarget,          // Agent, IntValue: target agent, -1 for the mouse
+	SetMaxLinearSpeed,  // Agent, FloatValue
+	SetMaxAngularSpeed, // Agent, FloatValue
+	SetMass,            // Agent, FloatValue
+	SetMouseTarget,     // Vector
+	SetTrimWorld,       // IntValue: enabled, FloatValue: size
+	SetUsePerception,   // IntValue: enabled
+
+	// @ End
+	Count
+};
+
+struct FSteeringSessionEvent final
+{
+	ESteeringSessionEvent Type{ESteeringSessionEvent::AddAgent};
+	int32 Agent{INDEX_NONE};
+	int32 IntValue{0};
+	float FloatValue{0.f};
+	FVector2D Vector{FVector2D::ZeroVector};
+
+	// Only the fields the event type uses are written
+	friend FArchive& operator<<(FArchive& Ar, FSteeringSessionEvent& Event);
+};
+
+struct FSteeringSessionFrame final
+{
+	float DeltaTime{0.f};
+	uint32 Checksum{0};
+	TArray<FSteeringSessionEvent> Events{};
+
+	friend FArchive& operator<<(FArchive& Ar, FSteeringSessionFrame& Frame);
+};
+
+struct FSteeringSessionLog final
+{
+	static constexpr uint32 Magic{0x52494147}; // "GAIR"
+	static constexpr uint32 Version{1};
+
+	uint64 Seed{0};
+	TArray<FSteeringSessionFrame> Frames{};
+
+	bool SaveToFile(const FString& Path) const;
+	bool LoadFromFile(const FString& Path);
+
+	static FString GetDefaultPath();
+};
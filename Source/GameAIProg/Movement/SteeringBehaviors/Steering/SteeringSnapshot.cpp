@@ -0,0 +1,115 @@
+#include "SteeringSnapshot.h"
+#include "GameAIProg/GameAIProg.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "Snapshots are written and mapped in native layout");
+
+FSteeringParams FSteeringSnapshotAgent::GetKinematics() const
+{
+	return FSteeringParams{FVector2D{Position}, Orientation, FVector2D{LinearVelocity}, AngularVelocity};
+}
+
+void FSteeringSnapshotAgent::SetKinematics(const FSteeringParams& Kinematics)
+{
+	Position = FVector2f{Kinematics.Position};
+	Orientation = Kinematics.Orientation;
+	LinearVelocity = FVector2f{Kinematics.LinearVelocity};
+	AngularVelocity = Kinematics.AngularVelocity;
+}
+
+FSteeringSnapshot::~FSteeringSnapshot()
+{
+	Close();
+}
+
+bool FSteeringSnapshot::Save(const FString& Path, const FVector2f& MouseTarget, TConstArrayView<FSteeringSnapshotAgent> Agents)
+{
+	const TUniquePtr<FArchive> Writer{IFileManager::Get().CreateFileWriter(*Path)};
+	if (!Writer)
+		return false;
+
+	FSteeringSnapshotHeader Header{};
+	Header.HeaderSize = sizeof(FSteeringSnapshotHeader);
+	Header.RecordSize = sizeof(FSteeringSnapshotAgent);
+	Header.NumAgents = static_cast<uint32>(Agents.Num());
+	Header.MouseTarget = MouseTarget;
+
+	// Records go out as they are in memory, that's what makes reading them in place possible
+	Writer->Serialize(&Header, sizeof(Header));
+	Writer->Serialize(const_cast<FSteeringSnapshotAgent*>(Agents.GetData()), Agents.Num() * sizeof(FSteeringSnapshotAgent));
+
+	return Writer->Close() && !Writer->IsError();
+}
+
+bool FSteeringSnapshot::Open(const FString& Path)
+{
+	Close();
+
+	IPlatformFile::FOpenMappedResult Mapped = FPlatformFileManager::Get().GetPlatformFile().OpenMappedEx(*Path);
+	if (Mapped.HasValue())
+	{
+		MappedFile = Mapped.StealValue();
+		MappedRegion.Reset(MappedFile->MapRegion());
+		if (MappedRegion && Validate(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize(), Path))
+			return true;
+
+		Close();
+		return false;
+	}
+
+	if (!FFileHelper::LoadFileToArray(Buffer, *Path))
+		return false;
+
+	if (Validate(Buffer.GetData(), Buffer.Num(), Path))
+		return true;
+
+	Close();
+	return false;
+}
+
+void FSteeringSnapshot::Close()
+{
+	Agents = {};
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	Buffer.Empty();
+}
+
+FString FSteeringSnapshot::GetDefaultPath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Snapshots") / TEXT("SteeringWorld.gais");
+}
+
+bool FSteeringSnapshot::Validate(const uint8* Data, int64 Size, const FString& Path)
+{
+	if (Size < static_cast<int64>(sizeof(FSteeringSnapshotHeader)))
+	{
+		UE_LOG(LogGameAIProg, Warning, TEXT("'%s' is too small to be a steering snapshot"), *Path);
+		return false;
+	}
+
+	FSteeringSnapshotHeader Header;
+	FMemory::Memcpy(&Header, Data, sizeof(Header));
+
+	if (Header.Magic != FSteeringSnapshotHeader::MagicValue || Header.Version != FSteeringSnapshotHeader::CurrentVersion
+		|| Header.HeaderSize != sizeof(FSteeringSnapshotHeader) || Header.RecordSize != sizeof(FSteeringSnapshotAgent))
+	{
+		UE_LOG(LogGameAIProg, Warning, TEXT("'%s' is not a steering snapshot of version %u"), *Path, FSteeringSnapshotHeader::CurrentVersion);
+		return false;
+	}
+
+	if (Header.NumAgents > static_cast<uint64>(Size - Header.HeaderSize) / Header.RecordSize)
+	{
+		UE_LOG(LogGameAIProg, Warning, TEXT("'%s' is truncated, it should hold %u agents"), *Path, Header.NumAgents);
+		return false;
+	}
+
+	Agents = TConstArrayView<FSteeringSnapshotAgent>{
+		reinterpret_cast<const FSteeringSnapshotAgent*>(Data + Header.HeaderSize), static_cast<int32>(Header.NumAgents)};
+	MouseTarget = Header.MouseTarget;
+	return true;
+}
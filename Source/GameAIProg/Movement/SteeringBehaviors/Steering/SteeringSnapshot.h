@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameAIProg/Movement/SteeringBehaviors/SteeringHelpers.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/*
+ * Snapshot of every agent of a steering level: kinematics, movement properties, behavior, target and the behavior's own
+ * state. The file is a fixed header followed by an array of fixed size records, so it is memory mapped and read in place:
+ * opening a snapshot of 100k agents is one map and a bounds check, nothing is parsed or copied.
+ *
+ * Records are written in native (little-endian) layout, bump Version whenever FSteeringSnapshotAgent changes.
+ */
+struct FSteeringSnapshotHeader final
+{
+	static constexpr uint32 MagicValue{0x53494147}; // "GAIS"
+	static constexpr uint32 CurrentVersion{1};
+
+	uint32 Magic{MagicValue};
+	uint32 Version{CurrentVersion};
+	uint32 HeaderSize{0};
+	uint32 RecordSize{0};
+	uint32 NumAgents{0};
+	FVector2f MouseTarget{FVector2f::ZeroVector};
+	uint32 Reserved{0};
+};
+
+struct FSteeringSnapshotAgent final
+{
+	uint64 Seed{0};          // seed the level hands to the agent's Wander
+	uint64 RandomSeed{0};    // Wander's random stream, mid-session
+	uint64 RandomCounter{0};
+
+	// FSteeringParams
+	FVector2f Position{FVector2f::ZeroVector};
+	float Orientation{0.f};
+	FVector2f LinearVelocity{FVector2f::ZeroVector};
+	float AngularVelocity{0.f};
+
+	float MaxLinearSpeed{0.f};
+	float MaxAngularSpeed{0.f};
+	float Mass{0.f};
+
+	int32 Target{-1}; // agent index, -1 for the mouse
+
+	float WanderOffset{0.f};
+	float WanderRadius{0.f};
+	float WanderMaxAngleChange{0.f};
+	float WanderAngle{0.f};
+
+	uint8 Behavior{0};
+	uint8 bAutoOrient{0};
+	uint8 bDebugRendering{0};
+	uint8 Padding[5]{};
+
+	FSteeringParams GetKinematics() const;
+	void SetKinematics(const FSteeringParams& Kinematics);
+};
+
+static_assert(sizeof(FSteeringSnapshotHeader) == 32, "Snapshot header layout changed, bump its version");
+static_assert(sizeof(FSteeringSnapshotAgent) == 88, "Snapshot record layout changed, bump the snapshot version");
+static_assert(std::is_trivially_copyable_v<FSteeringSnapshotAgent>, "Snapshot records are read in place");
+
+class FSteeringSnapshot final
+{
+public:
+	FSteeringSnapshot() = default;
+	~FSteeringSnapshot();
+
+	FSteeringSnapshot(const FSteeringSnapshot&) = delete;
+	FSteeringSnapshot& operator=(const FSteeringSnapshot&) = delete;
+
+	static bool Save(const FString& Path, const FVector2f& MouseTarget, TConstArrayView<FSteeringSnapshotAgent> Agents);
+
+	// Maps the file, falls back to reading it whole where mapping isn't supported
+	bool Open(const FString& Path);
+	void Close();
+
+	// Valid until Close
+	TConstArrayView<FSteeringSnapshotAgent> GetAgents() const { return Agents; }
+	FVector2f GetMouseTarget() const { return MouseTarget; }
+
+	static FString GetDefaultPath();
+
+private:
+	TUniquePtr<IMappedFileHandle> MappedFile{};
+	TUniquePtr<IMappedFileRegion> MappedRegion{};
+	TArray<uint8> Buffer{};
+
+	TConstArrayView<FSteeringSnapshotAgent> Agents{};
+	FVector2f MouseTarget{FVector2f::ZeroVector};
+
+	bool Validate(const uint8* Data, int64 Size, const FString& Path);
+};
@@ -1,6 +1,7 @@
 ﻿// Fill out your copyright notice in the Description page of Project Settings.
 
 #include "SteeringAgent.h"
+#include "GameAIProg/Shared/SpatialQuerySubsystem.h"
 
 
 // Sets default values
@@ -14,6 +15,17 @@ ASteeringAgent::ASteeringAgent()
 void ASteeringAgent::BeginPlay()
 {
 	Super::BeginPlay();
+
+	if (USpatialQuerySubsystem* SpatialQueries = GetWorld()->GetSubsystem<USpatialQuerySubsystem>())
+		SpatialQueries->RegisterAgent(this);
+}
+
+void ASteeringAgent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (USpatialQuerySubsystem* SpatialQueries = GetWorld()->GetSubsystem<USpatialQuerySubsystem>())
+		SpatialQueries->UnregisterAgent(this);
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ASteeringAgent::BeginDestroy()
@@ -59,6 +59,9 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// Called when the game ends or the agent is removed from the world
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	// Called when the object is being destroyed
 	virtual void BeginDestroy() override;
 
@@ -70,4 +73,5 @@ public:
 	virtual void SetupPlayerInputComponent(UInputComponent* PlayerInputComponent) override;
 
 	void SetSteeringBehavior(ISteeringBehavior* NewSteeringBehavior);
+	ISteeringBehavior* GetSteeringBehavior() const { return SteeringBehavior; }
 };
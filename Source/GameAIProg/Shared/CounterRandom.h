@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+ * Counter-based random numbers: the n-th number of a stream is a hash (SplitMix64) of its seed and n. There is no state
+ * besides the counter, so every owner can have its own stream, use it from any thread and replay it from (seed, counter).
+ */
+struct FCounterRandom final
+{
+	uint64 Seed{0};
+	uint64 Counter{0};
+
+	FCounterRandom() = default;
+	explicit FCounterRandom(uint64 InSeed) : Seed(Mix(InSeed)) {}
+
+	uint32 NextUInt() { return static_cast<uint32>(Mix(Seed + ++Counter * 0x9E3779B97F4A7C15ull) >> 32); }
+	// [0, 1)
+	float NextFloat() { return (NextUInt() >> 8) * (1.f / 16777216.f); }
+	// [-1, 1)
+	float NextSignedFloat() { return NextFloat() * 2.f - 1.f; }
+
+	static uint64 Mix(uint64 Value)
+	{
+		Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+};
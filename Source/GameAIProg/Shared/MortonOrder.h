@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <vector>
+
+/*
+ * Z-curve ordering of 2D positions. Sorting agent data by it puts agents that are close in the world close in memory,
+ * so neighbour loops stay on the same cache lines.
+ */
+namespace MortonOrder
+{
+	// Interleaves the bits of X and Y, X in the even bits
+	inline uint32 Encode(uint16 X, uint16 Y)
+	{
+		auto Spread = [](uint32 Value)
+		{
+			Value = (Value | (Value << 8)) & 0x00FF00FFu;
+			Value = (Value | (Value << 4)) & 0x0F0F0F0Fu;
+			Value = (Value | (Value << 2)) & 0x33333333u;
+			Value = (Value | (Value << 1)) & 0x55555555u;
+			return Value;
+		};
+		return Spread(X) | (Spread(Y) << 1);
+	}
+
+	// Writes the permutation that sorts Positions along the Z-curve: OutOrder[NewIndex] = OldIndex.
+	// Positions are quantized to CellSize, points sharing a cell keep their relative order. Keys is scratch, reused
+	// between calls so sorting doesn't allocate.
+	void Sort(const FVector2D* Positions, int32 Count, float CellSize, int32* OutOrder, std::vector<uint64>& Keys);
+
+	// Reorders the first Count Values in place by a permutation from Sort, following its cycles. Visited is scratch.
+	template <typename FValues>
+	void ApplyOrder(FValues& Values, const int32* Order, int32 Count, std::vector<uint8>& Visited)
+	{
+		Visited.assign(Count, 0);
+		for (int32 Start{0}; Start < Count; ++Start)
+		{
+			if (Visited[Start])
+				continue;
+
+			auto Value = MoveTemp(Values[Start]);
+			int32 Index = Start;
+			while (Order[Index] != Start)
+			{
+				Values[Index] = MoveTemp(Values[Order[Index]]);
+				Visited[Index] = 1;
+				Index = Order[Index];
+			}
+			Values[Index] = MoveTemp(Value);
+			Visited[Index] = 1;
+		}
+	}
+}
@@ -0,0 +1,173 @@
+#include "ObstacleIndex.h"
+#include "DrawDebugHelpers.h"
+
+namespace
+{
+	float Cross(const FVector2D& A, const FVector2D& B)
+	{
+		return A.X * B.Y - A.Y * B.X;
+	}
+
+	bool SegmentsIntersect(const FVector2D& P0, const FVector2D& P1, const FVector2D& Q0, const FVector2D& Q1)
+	{
+		const FVector2D R = P1 - P0;
+		const FVector2D S = Q1 - Q0;
+		const float Denominator = Cross(R, S);
+
+		// Parallel segments never block, a wall seen exactly edge-on has no thickness
+		if (FMath::IsNearlyZero(Denominator))
+			return false;
+
+		const FVector2D QP = Q0 - P0;
+		const float T = Cross(QP, S) / Denominator;
+		const float U = Cross(QP, R) / Denominator;
+		return T >= 0.f && T <= 1.f && U >= 0.f && U <= 1.f;
+	}
+}
+
+FObstacleIndex::FObstacleIndex(float InCellSize)
+	: CellSize(InCellSize)
+	, InvCellSize(1.f / InCellSize)
+{
+}
+
+void FObstacleIndex::Reset()
+{
+	Segments.clear();
+	CellStart.clear();
+	CellSegments.clear();
+	CellsX = CellsY = 0;
+}
+
+void FObstacleIndex::AddSegment(const FVector2D& A, const FVector2D& B)
+{
+	Segments.push_back(FSegment{A, B});
+}
+
+void FObstacleIndex::AddBox(const FBox2D& Box)
+{
+	const FVector2D Corners[4]{Box.Min, FVector2D{Box.Max.X, Box.Min.Y}, Box.Max, FVector2D{Box.Min.X, Box.Max.Y}};
+	for (int32 i{0}; i < 4; ++i)
+	{
+		AddSegment(Corners[i], Corners[(i + 1) % 4]);
+	}
+}
+
+void FObstacleIndex::Build()
+{
+	CellStart.clear();
+	CellSegments.clear();
+	CellsX = CellsY = 0;
+
+	if (Segments.empty())
+		return;
+
+	FBox2D Bounds{ForceInit};
+	for (const FSegment& Segment : Segments)
+	{
+		Bounds += Segment.A;
+		Bounds += Segment.B;
+	}
+
+	Origin = Bounds.Min;
+	CellsX = FMath::FloorToInt((Bounds.Max.X - Origin.X) * InvCellSize) + 1;
+	CellsY = FMath::FloorToInt((Bounds.Max.Y - Origin.Y) * InvCellSize) + 1;
+
+	// Segments go into every cell of their bounding rectangle, walls are short enough for that to stay tight
+	auto ForEachCell = [this](const FSegment& Segment, auto&& Callback)
+	{
+		const int32 MinX = FMath::FloorToInt((FMath::Min(Segment.A.X, Segment.B.X) - Origin.X) * InvCellSize);
+		const int32 MaxX = FMath::FloorToInt((FMath::Max(Segment.A.X, Segment.B.X) - Origin.X) * InvCellSize);
+		const int32 MinY = FMath::FloorToInt((FMath::Min(Segment.A.Y, Segment.B.Y) - Origin.Y) * InvCellSize);
+		const int32 MaxY = FMath::FloorToInt((FMath::Max(Segment.A.Y, Segment.B.Y) - Origin.Y) * InvCellSize);
+		for (int32 Y = MinY; Y <= MaxY; ++Y)
+		{
+			for (int32 X = MinX; X <= MaxX; ++X)
+			{
+				Callback(Y * CellsX + X);
+			}
+		}
+	};
+
+	CellStart.assign(static_cast<size_t>(CellsX) * CellsY + 1, 0);
+	for (const FSegment& Segment : Segments)
+	{
+		ForEachCell(Segment, [this](int32 Cell) { ++CellStart[Cell]; });
+	}
+
+	for (size_t Cell{1}; Cell < CellStart.size(); ++Cell)
+	{
+		CellStart[Cell] += CellStart[Cell - 1];
+	}
+
+	CellSegments.resize(CellStart.back());
+	for (int32 Segment = static_cast<int32>(Segments.size()) - 1; Segment >= 0; --Segment)
+	{
+		ForEachCell(Segments[Segment], [this, Segment](int32 Cell) { CellSegments[--CellStart[Cell]] = Segment; });
+	}
+}
+
+bool FObstacleIndex::IsBlocked(const FVector2D& From, const FVector2D& To) const
+{
+	if (CellsX == 0)
+		return false;
+
+	const FVector2D Start = (From - Origin) * InvCellSize;
+	const FVector2D End = (To - Origin) * InvCellSize;
+	const FVector2D Direction = End - Start;
+
+	int32 X = FMath::FloorToInt(Start.X);
+	int32 Y = FMath::FloorToInt(Start.Y);
+	const int32 StepX = Direction.X > 0.f ? 1 : -1;
+	const int32 StepY = Direction.Y > 0.f ? 1 : -1;
+
+	// Distances along the segment (in [0, 1]) to the next vertical and horizontal cell border
+	const float DeltaX = Direction.X != 0.f ? FMath::Abs(1.f / Direction.X) : BIG_NUMBER;
+	const float DeltaY = Direction.Y != 0.f ? FMath::Abs(1.f / Direction.Y) : BIG_NUMBER;
+	float NextX = Direction.X != 0.f ? (StepX > 0 ? X + 1 - Start.X : Start.X - X) * DeltaX : BIG_NUMBER;
+	float NextY = Direction.Y != 0.f ? (StepY > 0 ? Y + 1 - Start.Y : Start.Y - Y) * DeltaY : BIG_NUMBER;
+
+	const int32 NumSteps = FMath::Abs(FMath::FloorToInt(End.X) - X) + FMath::Abs(FMath::FloorToInt(End.Y) - Y);
+	for (int32 Step{0}; Step <= NumSteps; ++Step)
+	{
+		if (IsBlockedInCell(X, Y, From, To))
+			return true;
+
+		if (NextX < NextY)
+		{
+			NextX += DeltaX;
+			X += StepX;
+		}
+		else
+		{
+			NextY += DeltaY;
+			Y += StepY;
+		}
+	}
+
+	return false;
+}
+
+bool FObstacleIndex::IsBlockedInCell(int32 X, int32 Y, const FVector2D& From, const FVector2D& To) const
+{
+	if (X < 0 || Y < 0 || X >= CellsX || Y >= CellsY)
+		return false;
+
+	const int32 Cell = Y * CellsX + X;
+	for (int32 i = CellStart[Cell]; i < CellStart[Cell + 1]; ++i)
+	{
+		const FSegment& Segment = Segments[CellSegments[i]];
+		if (SegmentsIntersect(From, To, Segment.A, Segment.B))
+			return true;
+	}
+
+	return false;
+}
+
+void FObstacleIndex::DebugDraw(const UWorld* World, float Height) const
+{
+	for (const FSegment& Segment : Segments)
+	{
+		DrawDebugLine(World, FVector{Segment.A, Height}, FVector{Segment.B, Height}, FColor::Red);
+	}
+}
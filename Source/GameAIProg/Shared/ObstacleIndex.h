@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <vector>
+
+/*
+ * Static 2D obstacles (wall segments) bucketed in a uniform grid for line of sight tests.
+ *
+ * Add the obstacles, then Build once. A built index is read-only, IsBlocked can be called from any number of threads.
+ */
+class FObstacleIndex final
+{
+public:
+	explicit FObstacleIndex(float InCellSize = 200.f);
+
+	void Reset();
+	void AddSegment(const FVector2D& A, const FVector2D& B);
+	void AddBox(const FBox2D& Box);
+	void Build();
+
+	// Walks the cells the segment From-To crosses and tests it against the obstacles stored there
+	bool IsBlocked(const FVector2D& From, const FVector2D& To) const;
+
+	int32 GetNumSegments() const { return static_cast<int32>(Segments.size()); }
+	void DebugDraw(const UWorld* World, float Height) const;
+
+private:
+	struct FSegment
+	{
+		FVector2D A;
+		FVector2D B;
+	};
+
+	float CellSize{200.f};
+	float InvCellSize{1.f / 200.f};
+
+	std::vector<FSegment> Segments{};
+
+	FVector2D Origin{FVector2D::ZeroVector};
+	int32 CellsX{0};
+	int32 CellsY{0};
+	std::vector<int32> CellStart{};    // CellsX * CellsY + 1 prefix sums into CellSegments
+	std::vector<int32> CellSegments{};
+
+	bool IsBlockedInCell(int32 X, int32 Y, const FVector2D& From, const FVector2D& To) const;
+};
@@ -0,0 +1,362 @@
+#include "SpatialHash.h"
+#include "MortonOrder.h"
+#include "GameAIProg/GameAIProg.h"
+#include "HAL/IConsoleManager.h"
+#include <algorithm>
+
+FSpatialHash::FSpatialHash(float InCellSize, int32 InNumBuckets)
+	: CellSize(InCellSize)
+	, InvCellSize(1.f / InCellSize)
+	, BucketMask(FMath::RoundUpToPowerOfTwo(InNumBuckets) - 1)
+	, BucketStart(BucketMask + 2, 0)
+	, MovedHead(BucketMask + 1, INDEX_NONE)
+{
+}
+
+void FSpatialHash::Build(const FVector2D* InPositions, int32 Count)
+{
+	Positions.assign(InPositions, InPositions + Count);
+	Rebuild();
+}
+
+void FSpatialHash::Update(const FVector2D* InPositions, int32 Count)
+{
+	if (Count != Num())
+	{
+		Build(InPositions, Count);
+		return;
+	}
+
+	for (int32 i{0}; i < Count; ++i)
+	{
+		Positions[i] = InPositions[i];
+
+		const FIntPoint Cell = GetCell(Positions[i]);
+		if (Cell == PointCells[i])
+			continue;
+
+		if (bMoved[i])
+			Unlink(i, GetBucket(PointCells[i]));
+		PointCells[i] = Cell;
+
+		if (Cell == HomeCells[i])
+		{
+			bMoved[i] = 0;
+			--NumMoved;
+		}
+		else
+		{
+			NumMoved += 1 - bMoved[i];
+			bMoved[i] = 1;
+			Link(i, GetBucket(Cell));
+		}
+	}
+
+	if (NumMoved > Count / CompactionDivisor)
+		Rebuild();
+}
+
+void FSpatialHash::Permute(const int32* Order)
+{
+	const int32 Count = Num();
+	NewIndices.resize(Count);
+	for (int32 i{0}; i < Count; ++i)
+	{
+		NewIndices[Order[i]] = i;
+	}
+
+	// The grid stores point indices, only the links of moved points hold any
+	for (int32& Index : Entries)
+	{
+		Index = NewIndices[Index];
+	}
+	for (int32& Head : MovedHead)
+	{
+		if (Head != INDEX_NONE)
+			Head = NewIndices[Head];
+	}
+	for (int32 i{0}; i < Count; ++i)
+	{
+		if (!bMoved[i])
+			continue;
+
+		if (MovedNext[i] != INDEX_NONE)
+			MovedNext[i] = NewIndices[MovedNext[i]];
+		if (MovedPrev[i] != INDEX_NONE)
+			MovedPrev[i] = NewIndices[MovedPrev[i]];
+	}
+
+	MortonOrder::ApplyOrder(Positions, Order, Count, Visited);
+	MortonOrder::ApplyOrder(PointCells, Order, Count, Visited);
+	MortonOrder::ApplyOrder(HomeCells, Order, Count, Visited);
+	MortonOrder::ApplyOrder(bMoved, Order, Count, Visited);
+	MortonOrder::ApplyOrder(MovedNext, Order, Count, Visited);
+	MortonOrder::ApplyOrder(MovedPrev, Order, Count, Visited);
+}
+
+void FSpatialHash::Rebuild()
+{
+	const int32 Count = Num();
+	PointBuckets.resize(Count);
+	Entries.resize(Count);
+	EntryCells.resize(Count);
+	PointCells.resize(Count);
+	HomeCells.resize(Count);
+	bMoved.assign(Count, 0);
+	MovedNext.resize(Count);
+	MovedPrev.resize(Count);
+	MovedHead.assign(BucketMask + 1, INDEX_NONE);
+	NumMoved = 0;
+
+	std::fill(BucketStart.begin(), BucketStart.end(), 0);
+	for (int32 i{0}; i < Count; ++i)
+	{
+		PointCells[i] = HomeCells[i] = GetCell(Positions[i]);
+		PointBuckets[i] = GetBucket(PointCells[i]);
+		++BucketStart[PointBuckets[i]];
+	}
+
+	for (size_t Bucket{1}; Bucket < BucketStart.size(); ++Bucket)
+	{
+		BucketStart[Bucket] += BucketStart[Bucket - 1];
+	}
+
+	// Every bucket now holds its end, filling back to front leaves it holding its start
+	for (int32 i = Count - 1; i >= 0; --i)
+	{
+		const int32 Entry = --BucketStart[PointBuckets[i]];
+		Entries[Entry] = i;
+		EntryCells[Entry] = PointCells[i];
+	}
+}
+
+void FSpatialHash::Link(int32 Index, uint32 Bucket)
+{
+	MovedPrev[Index] = INDEX_NONE;
+	MovedNext[Index] = MovedHead[Bucket];
+	if (MovedHead[Bucket] != INDEX_NONE)
+		MovedPrev[MovedHead[Bucket]] = Index;
+	MovedHead[Bucket] = Index;
+}
+
+void FSpatialHash::Unlink(int32 Index, uint32 Bucket)
+{
+	if (MovedPrev[Index] != INDEX_NONE)
+		MovedNext[MovedPrev[Index]] = MovedNext[Index];
+	else
+		MovedHead[Bucket] = MovedNext[Index];
+
+	if (MovedNext[Index] != INDEX_NONE)
+		MovedPrev[MovedNext[Index]] = MovedPrev[Index];
+}
+
+int32 FSpatialHash::QueryRadius(const FVector2D& Center, float Radius, int32* OutIndices, int32 MaxResults, int32 IgnoreIndex) const
+{
+	const FIntPoint MinCell = GetCell(Center - FVector2D{Radius});
+	const FIntPoint MaxCell = GetCell(Center + FVector2D{Radius});
+	const float RadiusSq = Radius * Radius;
+
+	int32 NumResults{0};
+	const auto AddIfInRange = [&](int32 Index)
+	{
+		if (Index != IgnoreIndex && FVector2D::DistSquared(Positions[Index], Center) <= RadiusSq)
+			OutIndices[NumResults++] = Index;
+		return NumResults < MaxResults;
+	};
+
+	for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			if (!ForEachInCell(FIntPoint{X, Y}, AddIfInRange))
+				return NumResults;
+		}
+	}
+
+	return NumResults;
+}
+
+template <typename FFilter>
+int32 FSpatialHash::QueryNearestFiltered(const FVector2D& Center, int32 K, float MaxRadius, int32* OutIndices, FFilter&& Filter) const
+{
+	K = FMath::Min(K, MaxNearest);
+	if (K <= 0)
+		return 0;
+
+	// OutIndices and Distances stay sorted closest first, K is small enough for insertion
+	float Distances[MaxNearest];
+	int32 NumResults{0};
+	const float MaxRadiusSq = MaxRadius * MaxRadius;
+
+	const auto Insert = [&](int32 Index)
+	{
+		const float DistanceSq = FVector2D::DistSquared(Positions[Index], Center);
+		if (DistanceSq > MaxRadiusSq || (NumResults == K && DistanceSq >= Distances[K - 1]) || !Filter(Index))
+			return true;
+
+		int32 Slot = FMath::Min(NumResults, K - 1);
+		for (; Slot > 0 && Distances[Slot - 1] > DistanceSq; --Slot)
+		{
+			Distances[Slot] = Distances[Slot - 1];
+			OutIndices[Slot] = OutIndices[Slot - 1];
+		}
+		Distances[Slot] = DistanceSq;
+		OutIndices[Slot] = Index;
+		NumResults = FMath::Min(NumResults + 1, K);
+		return true;
+	};
+
+	// Search square rings of cells around the center, every point in ring R is at least (R - 1) cells away
+	const FIntPoint CenterCell = GetCell(Center);
+	const int32 MaxRing = FMath::CeilToInt(MaxRadius * InvCellSize);
+	for (int32 Ring{0}; Ring <= MaxRing; ++Ring)
+	{
+		const float RingDistance = (Ring - 1) * CellSize;
+		if (NumResults == K && RingDistance > 0.f && RingDistance * RingDistance > Distances[K - 1])
+			break;
+
+		if (Ring == 0)
+		{
+			ForEachInCell(CenterCell, Insert);
+			continue;
+		}
+
+		for (int32 X = -Ring; X <= Ring; ++X)
+		{
+			ForEachInCell(CenterCell + FIntPoint{X, -Ring}, Insert);
+			ForEachInCell(CenterCell + FIntPoint{X, Ring}, Insert);
+		}
+		for (int32 Y = -Ring + 1; Y < Ring; ++Y)
+		{
+			ForEachInCell(CenterCell + FIntPoint{-Ring, Y}, Insert);
+			ForEachInCell(CenterCell + FIntPoint{Ring, Y}, Insert);
+		}
+	}
+
+	return NumResults;
+}
+
+int32 FSpatialHash::QueryNearest(const FVector2D& Center, int32 K, float MaxRadius, int32* OutIndices, int32 IgnoreIndex) const
+{
+	return QueryNearestFiltered(Center, K, MaxRadius, OutIndices, [IgnoreIndex](int32 Index) { return Index != IgnoreIndex; });
+}
+
+int32 FSpatialHash::QueryConeNearest(const FVector2D& Center, const FVector2D& Forward, float HalfAngle, int32 K, float MaxRadius,
+	int32* OutIndices, int32 IgnoreIndex) const
+{
+	const float CosHalfAngle = FMath::Cos(FMath::DegreesToRadians(HalfAngle));
+	return QueryNearestFiltered(Center, K, MaxRadius, OutIndices, [&](int32 Index)
+	{
+		const FVector2D ToPoint = Positions[Index] - Center;
+		return Index != IgnoreIndex && (ToPoint | Forward) >= CosHalfAngle * ToPoint.Size();
+	});
+}
+
+int32 FSpatialHash::QueryCone(const FVector2D& Center, const FVector2D& Forward, float HalfAngle, float Radius, int32* OutIndices,
+	int32 MaxResults, int32 IgnoreIndex) const
+{
+	const FIntPoint MinCell = GetCell(Center - FVector2D{Radius});
+	const FIntPoint MaxCell = GetCell(Center + FVector2D{Radius});
+	const float RadiusSq = Radius * Radius;
+	const float CosHalfAngle = FMath::Cos(FMath::DegreesToRadians(HalfAngle));
+
+	int32 NumResults{0};
+	const auto AddIfInCone = [&](int32 Index)
+	{
+		const FVector2D ToPoint = Positions[Index] - Center;
+		const float DistanceSq = ToPoint.SizeSquared();
+		if (Index != IgnoreIndex && DistanceSq <= RadiusSq && (ToPoint | Forward) >= CosHalfAngle * FMath::Sqrt(DistanceSq))
+			OutIndices[NumResults++] = Index;
+		return NumResults < MaxResults;
+	};
+
+	for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			if (!ForEachInCell(FIntPoint{X, Y}, AddIfInCone))
+				return NumResults;
+		}
+	}
+
+	return NumResults;
+}
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+	// Agents random walk at walking speed through a world sized for one agent per cell, like a busy steering level
+	void RunSpatialHashBenchmark(int32 NumAgents)
+	{
+		constexpr int32 NumFrames{120};
+		constexpr float DeltaT{1.f / 60.f};
+		constexpr float Speed{400.f};
+		constexpr float QueryRadius{400.f};
+		const float WorldSize = 200.f * FMath::Sqrt(static_cast<float>(NumAgents));
+
+		FRandomStream Random{NumAgents};
+		std::vector<FVector2D> Positions(NumAgents);
+		std::vector<FVector2D> Velocities(NumAgents);
+		for (int32 i{0}; i < NumAgents; ++i)
+		{
+			Positions[i] = FVector2D{Random.FRand(), Random.FRand()} * WorldSize;
+			Velocities[i] = FVector2D{Random.FRandRange(-1.f, 1.f), Random.FRandRange(-1.f, 1.f)}.GetSafeNormal() * Speed;
+		}
+
+		FSpatialHash Rebuilt{};
+		FSpatialHash Incremental{};
+		Rebuilt.Build(Positions.data(), NumAgents);
+		Incremental.Build(Positions.data(), NumAgents);
+
+		double RebuildSeconds{0.0};
+		double IncrementalSeconds{0.0};
+		int64 RebuiltFound{0};
+		int64 IncrementalFound{0};
+		int32 Found[256];
+
+		for (int32 Frame{0}; Frame < NumFrames; ++Frame)
+		{
+			for (int32 i{0}; i < NumAgents; ++i)
+			{
+				Velocities[i] = Velocities[i].GetRotated(Random.FRandRange(-10.f, 10.f));
+				Positions[i] += Velocities[i] * DeltaT;
+				Positions[i].X = FMath::Wrap(Positions[i].X, 0.f, WorldSize);
+				Positions[i].Y = FMath::Wrap(Positions[i].Y, 0.f, WorldSize);
+			}
+
+			const double Start = FPlatformTime::Seconds();
+			Rebuilt.Build(Positions.data(), NumAgents);
+			const double Middle = FPlatformTime::Seconds();
+			Incremental.Update(Positions.data(), NumAgents);
+			const double End = FPlatformTime::Seconds();
+
+			RebuildSeconds += Middle - Start;
+			IncrementalSeconds += End - Middle;
+
+			// Both must answer queries the same
+			for (int32 i{0}; i < NumAgents; i += 97)
+			{
+				RebuiltFound += Rebuilt.QueryRadius(Positions[i], QueryRadius, Found, UE_ARRAY_COUNT(Found));
+				IncrementalFound += Incremental.QueryRadius(Positions[i], QueryRadius, Found, UE_ARRAY_COUNT(Found));
+			}
+		}
+
+		UE_LOG(LogGameAIProg, Display, TEXT("SpatialHash %6d agents: rebuild %.3f ms, incremental %.3f ms per frame (%d points moved)"),
+			NumAgents, RebuildSeconds * 1000.0 / NumFrames, IncrementalSeconds * 1000.0 / NumFrames, Incremental.GetNumMoved());
+
+		if (RebuiltFound != IncrementalFound)
+			UE_LOG(LogGameAIProg, Error, TEXT("SpatialHash results differ: %lld vs %lld"), RebuiltFound, IncrementalFound);
+	}
+
+	FAutoConsoleCommand SpatialHashBenchmarkCommand(
+		TEXT("GameAI.Benchmark.SpatialHash"),
+		TEXT("Compares rebuilding the agent spatial hash every frame with incremental updates at 1k, 10k and 50k agents"),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			for (const int32 NumAgents : {1000, 10000, 50000})
+			{
+				RunSpatialHashBenchmark(NumAgents);
+			}
+		}));
+}
+#endif
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <vector>
+
+/*
+ * Hashed uniform grid over a set of 2D points.
+ *
+ * Building is a counting sort of the point indices on their cell's hash bucket, so the points of one bucket are contiguous
+ * and the grid has no per-cell allocations. The world does not need to be bounded, distinct cells sharing a bucket are
+ * told apart by the cell stored next to every entry.
+ *
+ * Update only touches points that crossed into another cell: they leave the sorted entries and go into an intrusive list
+ * per bucket instead (and back once they return to the cell they were sorted in). When too many points live in the lists
+ * the next Update compacts everything into sorted order again.
+ *
+ * Queries are const and write into caller provided buffers, any number of threads can query a built hash.
+ */
+class FSpatialHash final
+{
+public:
+	explicit FSpatialHash(float InCellSize = 200.f, int32 InNumBuckets = 4096);
+
+	void Build(const FVector2D* InPositions, int32 Count);
+	// Same points (count and order) at new positions, falls back to Build when the count changed
+	void Update(const FVector2D* InPositions, int32 Count);
+	// Same points in a new order, Order[NewIndex] = OldIndex. Remaps the grid in place, points that moved stay in their
+	// lists until the next compaction
+	void Permute(const int32* Order);
+
+	static constexpr int32 MaxNearest{64};
+
+	// All queries write point indices into OutIndices and return how many were written, IgnoreIndex is never returned
+
+	// Points within Radius of Center, in no particular order
+	int32 QueryRadius(const FVector2D& Center, float Radius, int32* OutIndices, int32 MaxResults, int32 IgnoreIndex = INDEX_NONE) const;
+	// The (at most MaxNearest) K points closest to Center and no further than MaxRadius, closest first
+	int32 QueryNearest(const FVector2D& Center, int32 K, float MaxRadius, int32* OutIndices, int32 IgnoreIndex = INDEX_NONE) const;
+	// Points within Radius of Center and HalfAngle (degrees) of Forward, which must be normalized
+	int32 QueryCone(const FVector2D& Center, const FVector2D& Forward, float HalfAngle, float Radius, int32* OutIndices, int32 MaxResults,
+		int32 IgnoreIndex = INDEX_NONE) const;
+	// The (at most MaxNearest) K points of the cone closest to Center, closest first
+	int32 QueryConeNearest(const FVector2D& Center, const FVector2D& Forward, float HalfAngle, int32 K, float MaxRadius, int32* OutIndices,
+		int32 IgnoreIndex = INDEX_NONE) const;
+
+	int32 Num() const { return static_cast<int32>(Positions.size()); }
+	const FVector2D& GetPosition(int32 Index) const { return Positions[Index]; }
+	int32 GetNumMoved() const { return NumMoved; }
+
+private:
+	float CellSize{200.f};
+	float InvCellSize{1.f / 200.f};
+	uint32 BucketMask{0};
+
+	std::vector<FVector2D> Positions{};
+	std::vector<uint32> PointBuckets{}; // scratch, bucket of every point during Build
+	std::vector<int32> BucketStart{};   // NumBuckets + 1 prefix sums into Entries
+	std::vector<int32> Entries{};       // point indices ordered by bucket
+	std::vector<FIntPoint> EntryCells{};
+
+	// Points that left the cell they were sorted in, linked per bucket
+	static constexpr int32 CompactionDivisor{8}; // compact once more than 1 in 8 points moved
+	std::vector<FIntPoint> PointCells{};
+	std::vector<FIntPoint> HomeCells{};
+	std::vector<uint8> bMoved{};
+	std::vector<int32> MovedHead{};
+	std::vector<int32> MovedNext{};
+	std::vector<int32> MovedPrev{};
+	int32 NumMoved{0};
+
+	// Scratch for Permute
+	std::vector<int32> NewIndices{};
+	std::vector<uint8> Visited{};
+
+	void Rebuild();
+
+	// Ring search shared by the nearest queries, points failing the filter are skipped
+	template <typename FFilter>
+	int32 QueryNearestFiltered(const FVector2D& Center, int32 K, float MaxRadius, int32* OutIndices, FFilter&& Filter) const;
+	void Link(int32 Index, uint32 Bucket);
+	void Unlink(int32 Index, uint32 Bucket);
+
+	FIntPoint GetCell(const FVector2D& Position) const
+	{
+		return FIntPoint{FMath::FloorToInt(Position.X * InvCellSize), FMath::FloorToInt(Position.Y * InvCellSize)};
+	}
+
+	uint32 GetBucket(const FIntPoint& Cell) const
+	{
+		return (static_cast<uint32>(Cell.X) * 73856093u ^ static_cast<uint32>(Cell.Y) * 19349663u) & BucketMask;
+	}
+
+	// Callback returns false to stop, so does ForEachInCell
+	template <typename FCallback>
+	bool ForEachInCell(const FIntPoint& Cell, FCallback&& Callback) const
+	{
+		const uint32 Bucket = GetBucket(Cell);
+		for (int32 Entry = BucketStart[Bucket]; Entry < BucketStart[Bucket + 1]; ++Entry)
+		{
+			if (EntryCells[Entry] == Cell && !bMoved[Entries[Entry]] && !Callback(Entries[Entry]))
+				return false;
+		}
+		for (int32 Index = MovedHead[Bucket]; Index != INDEX_NONE; Index = MovedNext[Index])
+		{
+			if (PointCells[Index] == Cell && !Callback(Index))
+				return false;
+		}
+		return true;
+	}
+};
@@ -0,0 +1,125 @@
+#include "SpatialQuerySubsystem.h"
+#include "MortonOrder.h"
+#include "Async/ParallelFor.h"
+#include "GameAIProg/Movement/SteeringBehaviors/SteeringAgent.h"
+
+void USpatialQuerySubsystem::RegisterAgent(ASteeringAgent* Agent)
+{
+	if (IsValid(Agent) && !Agents.Contains(Agent))
+	{
+		Agents.Add(Agent);
+		bDirty = true;
+	}
+}
+
+void USpatialQuerySubsystem::UnregisterAgent(ASteeringAgent* Agent)
+{
+	if (Agents.RemoveSwap(Agent) > 0)
+		bDirty = true;
+}
+
+void USpatialQuerySubsystem::Refresh()
+{
+	if (!bDirty && LastRefreshFrame == GFrameCounter)
+		return;
+
+	LastRefreshFrame = GFrameCounter;
+
+	// Agents destroyed without unregistering are dropped here
+	if (Agents.RemoveAllSwap([](const TObjectPtr<ASteeringAgent>& Agent) { return !IsValid(Agent); }) > 0)
+		bDirty = true;
+
+	const int32 NumAgents = Agents.Num();
+	Snapshot.SetNumUninitialized(NumAgents);
+	Positions.SetNumUninitialized(NumAgents);
+	Forwards.SetNumUninitialized(NumAgents);
+
+	for (int32 i{0}; i < NumAgents; ++i)
+	{
+		ASteeringAgent* const Agent = Agents[i];
+		Snapshot[i] = Agent;
+		Positions[i] = Agent->GetPosition();
+
+		float Sin, Cos;
+		FMath::SinCos(&Sin, &Cos, FMath::DegreesToRadians(Agent->GetRotation()));
+		Forwards[i] = FVector2D{Cos, Sin};
+	}
+
+	// Same agents in the same order as last time, only the ones that changed cell need to move
+	if (bDirty)
+		SpatialHash.Build(Positions.GetData(), NumAgents);
+	else
+		SpatialHash.Update(Positions.GetData(), NumAgents);
+
+	// Sorting only reorders the hash, it keeps its incremental state
+	if (++RefreshesSinceSort >= MortonSortInterval)
+	{
+		SortAlongZCurve();
+		bDirty = true;
+	}
+
+	if (bDirty)
+	{
+		SnapshotIndices.Reset();
+		for (int32 i{0}; i < NumAgents; ++i)
+		{
+			SnapshotIndices.Add(Snapshot[i], i);
+		}
+	}
+
+	bDirty = false;
+}
+
+void USpatialQuerySubsystem::QueryRadiusBatch(TConstArrayView<int32> Queriers, float Radius, int32 MaxPerQuery, int32* OutIndices,
+	int32* OutCounts) const
+{
+	constexpr int32 MinBatchSize{32};
+	ParallelFor(TEXT("SpatialQueryRadiusBatch"), Queriers.Num(), MinBatchSize, [&](int32 i)
+	{
+		const int32 Querier = Queriers[i];
+		OutCounts[i] = SpatialHash.QueryRadius(GetPosition(Querier), Radius, OutIndices + i * MaxPerQuery, MaxPerQuery, Querier);
+	});
+}
+
+void USpatialQuerySubsystem::QueryNearestBatch(TConstArrayView<int32> Queriers, int32 K, float MaxRadius, int32* OutIndices,
+	int32* OutCounts) const
+{
+	constexpr int32 MinBatchSize{32};
+	ParallelFor(TEXT("SpatialQueryNearestBatch"), Queriers.Num(), MinBatchSize, [&](int32 i)
+	{
+		const int32 Querier = Queriers[i];
+		OutCounts[i] = SpatialHash.QueryNearest(GetPosition(Querier), K, MaxRadius, OutIndices + i * K, Querier);
+	});
+}
+
+void USpatialQuerySubsystem::SortAlongZCurve()
+{
+	RefreshesSinceSort = 0;
+
+	const int32 NumAgents = Agents.Num();
+	SortOrder.SetNumUninitialized(NumAgents);
+	MortonOrder::Sort(Positions.GetData(), NumAgents, 200.f, SortOrder.GetData(), SortKeys);
+
+	MortonOrder::ApplyOrder(Agents, SortOrder.GetData(), NumAgents, SortVisited);
+	MortonOrder::ApplyOrder(Snapshot, SortOrder.GetData(), NumAgents, SortVisited);
+	MortonOrder::ApplyOrder(Positions, SortOrder.GetData(), NumAgents, SortVisited);
+	MortonOrder::ApplyOrder(Forwards, SortOrder.GetData(), NumAgents, SortVisited);
+	SpatialHash.Permute(SortOrder.GetData());
+}
+
+int32 USpatialQuerySubsystem::FindAgent(const ASteeringAgent* Agent) const
+{
+	const int32* const Index = SnapshotIndices.Find(Agent);
+	return Index ? *Index : INDEX_NONE;
+}
+
+void USpatialQuerySubsystem::Deinitialize()
+{
+	Agents.Empty();
+	Snapshot.Empty();
+	Positions.Empty();
+	Forwards.Empty();
+	SnapshotIndices.Empty();
+
+	Super::Deinitialize();
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SpatialHash.h"
+#include <vector>
+#include "SpatialQuerySubsystem.generated.h"
+
+class ASteeringAgent;
+
+/*
+ * "Which agents are near me" for every level. Steering agents register themselves on BeginPlay.
+ *
+ * Refresh snapshots the agents' positions and headings into an FSpatialHash, at most once per frame. Query results are
+ * indices into that snapshot (see GetAgent/GetPosition/GetForward) and stay valid until the next Refresh. Queries
+ * never allocate and are safe to run from worker threads, as long as nobody refreshes at the same time.
+ *
+ * Every MortonSortInterval refreshes the agents are re-sorted along a Z-curve, so agents close in the world are close in
+ * the snapshot too. That changes every index: hold on to agents (FindAgent), not to indices, across frames.
+ */
+UCLASS()
+class GAMEAIPROG_API USpatialQuerySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterAgent(ASteeringAgent* Agent);
+	void UnregisterAgent(ASteeringAgent* Agent);
+
+	void Refresh();
+
+	int32 QueryRadius(const FVector2D& Center, float Radius, int32* OutIndices, int32 MaxResults, int32 IgnoreIndex = INDEX_NONE) const
+	{
+		return SpatialHash.QueryRadius(Center, Radius, OutIndices, MaxResults, IgnoreIndex);
+	}
+	int32 QueryNearest(const FVector2D& Center, int32 K, float MaxRadius, int32* OutIndices, int32 IgnoreIndex = INDEX_NONE) const
+	{
+		return SpatialHash.QueryNearest(Center, K, MaxRadius, OutIndices, IgnoreIndex);
+	}
+	int32 QueryCone(const FVector2D& Center, const FVector2D& Forward, float HalfAngle, float Radius, int32* OutIndices, int32 MaxResults,
+		int32 IgnoreIndex = INDEX_NONE) const
+	{
+		return SpatialHash.QueryCone(Center, Forward, HalfAngle, Radius, OutIndices, MaxResults, IgnoreIndex);
+	}
+	int32 QueryConeNearest(const FVector2D& Center, const FVector2D& Forward, float HalfAngle, int32 K, float MaxRadius, int32* OutIndices,
+		int32 IgnoreIndex = INDEX_NONE) const
+	{
+		return SpatialHash.QueryConeNearest(Center, Forward, HalfAngle, K, MaxRadius, OutIndices, IgnoreIndex);
+	}
+
+	// One radius query per snapshot agent in Queriers, every query gets MaxPerQuery slots in OutIndices and its count in
+	// OutCounts. Queriers are excluded from their own results. Runs in parallel.
+	void QueryRadiusBatch(TConstArrayView<int32> Queriers, float Radius, int32 MaxPerQuery, int32* OutIndices, int32* OutCounts) const;
+	void QueryNearestBatch(TConstArrayView<int32> Queriers, int32 K, float MaxRadius, int32* OutIndices, int32* OutCounts) const;
+
+	int32 GetNumAgents() const { return Snapshot.Num(); }
+	ASteeringAgent* GetAgent(int32 Index) const { return Snapshot[Index]; }
+	const FVector2D& GetPosition(int32 Index) const { return SpatialHash.GetPosition(Index); }
+	const FVector2D& GetForward(int32 Index) const { return Forwards[Index]; }
+	int32 FindAgent(const ASteeringAgent* Agent) const; // snapshot index, INDEX_NONE if not in the snapshot
+
+	virtual void Deinitialize() override;
+
+private:
+	UPROPERTY()
+	TArray<TObjectPtr<ASteeringAgent>> Agents;
+
+	TArray<ASteeringAgent*> Snapshot;
+	TArray<FVector2D> Positions;
+	TArray<FVector2D> Forwards;
+	TMap<const ASteeringAgent*, int32> SnapshotIndices;
+
+	FSpatialHash SpatialHash{};
+	uint64 LastRefreshFrame{0};
+	bool bDirty{true};
+
+	static constexpr int32 MortonSortInterval{60};
+	int32 RefreshesSinceSort{0};
+	TArray<int32> SortOrder;
+	std::vector<uint64> SortKeys;   // scratch
+	std::vector<uint8> SortVisited; // scratch
+
+	void SortAlongZCurve();
+};
@@ -0,0 +1,41 @@
+#include "TrigTable.h"
+
+namespace
+{
+	constexpr int32 TableSize{1024}; // power of two, wrapping is a mask
+
+	struct FSineTable
+	{
+		float Values[TableSize + 1]; // one extra entry so the lerp never wraps
+
+		FSineTable()
+		{
+			for (int32 i{0}; i <= TableSize; ++i)
+			{
+				Values[i] = FMath::Sin(UE_TWO_PI * i / TableSize);
+			}
+		}
+	};
+
+	const FSineTable& GetSineTable()
+	{
+		static const FSineTable Table{};
+		return Table;
+	}
+}
+
+void TrigTable::SinCos(float Radians, float& OutSin, float& OutCos)
+{
+	const FSineTable& Table = GetSineTable();
+
+	const float Position = Radians * (TableSize / UE_TWO_PI);
+	const float Floor = FMath::FloorToFloat(Position);
+	const float Alpha = Position - Floor;
+	const int32 Index = static_cast<int32>(static_cast<int64>(Floor) & (TableSize - 1));
+
+	// cos(x) = sin(x + quarter turn)
+	const int32 CosIndex = (Index + TableSize / 4) & (TableSize - 1);
+
+	OutSin = FMath::Lerp(Table.Values[Index], Table.Values[Index + 1], Alpha);
+	OutCos = FMath::Lerp(Table.Values[CosIndex], Table.Values[CosIndex + 1], Alpha);
+}
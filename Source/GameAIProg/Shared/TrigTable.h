@@ -0,0 +1,9 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Sine and cosine from one shared 1024 entry table with linear interpolation, absolute error below 5e-6
+namespace TrigTable
+{
+	void SinCos(float Radians, float& OutSin, float& OutCos);
+}